@@ -84,6 +84,69 @@ static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
 */
 static void prvHeapInit( void );
 
+/*
+* Returns the size of the largest block in the list of free blocks, header
+* included. Must be called with the scheduler suspended.
+*/
+static size_t prvLargestFreeBlockSize( void );
+
+#ifdef HEAP_TRACE
+/*
+* Optional tracing of the allocations, enabled with -DHEAP_TRACE=1.
+*
+* Each allocation and free is recorded into a ring buffer together with its
+* call site and the state of the heap after the operation. xHeapTrace is read
+* from RAM with a debugger (see doc/MemoryAnalysis.md) and decoded by
+* tools/heap_trace.py.
+*/
+#ifndef HEAP_TRACE_RECORDS
+ #define HEAP_TRACE_RECORDS 128
+#endif
+
+#define heapTRACE_MAGIC 0x43525448UL /* "HTRC" */
+#define heapTRACE_VERSION 1
+/* Offset of failed allocations */
+#define heapTRACE_NO_BLOCK 0xFFFF
+
+typedef struct
+{
+ uint32_t ulTimestamp;        /*<< Tick count. */
+ uint32_t ulCallSite;         /*<< Caller of the allocator or of its wrapper (malloc(), LvglPoolAlloc()...), bit 0 (Thumb bit) is 0 for allocations and 1 for frees. */
+ uint16_t usOffset;           /*<< From the start of the heap, heapTRACE_NO_BLOCK for failed allocations. */
+ uint16_t usSize;             /*<< Requested size for allocations, size of the block for frees. */
+ uint16_t usFreeSize;         /*<< Free bytes after the operation. */
+ uint16_t usLargestFreeBlock; /*<< Largest allocation that could succeed after the operation. */
+} HeapTraceRecord_t;
+
+typedef struct
+{
+ uint32_t ulMagic;
+ uint16_t usVersion;
+ uint16_t usRecordSize;
+ uint32_t ulCapacity;
+ uint32_t ulRecorded; /*<< Total number of records, the oldest ones have been overwritten when greater than ulCapacity. */
+ uint32_t ulHeapStart;
+ uint32_t ulHeapSize;
+ HeapTraceRecord_t xRecords[ HEAP_TRACE_RECORDS ];
+} HeapTrace_t;
+
+HeapTrace_t xHeapTrace;
+
+/*
+* Adds a record to xHeapTrace. Must be called with the scheduler suspended.
+*/
+static void prvHeapTraceRecord( void *pv, size_t xSize, void *pvCallSite, uint32_t ulIsFree );
+#endif
+
+/*
+* Same as pvPortMalloc(), vPortFree() and pvPortRealloc(), for the wrappers of the
+* allocator: pvCallSite is recorded in the heap trace instead of the return
+* address, which would be the one of the wrapper.
+*/
+void *pvPortMallocFrom( size_t xWantedSize, void *pvCallSite );
+void vPortFreeFrom( void *pv, void *pvCallSite );
+void *pvPortReallocFrom( void *pv, size_t xWantedSize, void *pvCallSite );
+
 /*-----------------------------------------------------------*/
 
 /* The size of the structure placed at the beginning of each allocated memory
@@ -109,9 +172,20 @@ static size_t xHeapSize = 0;
 /*-----------------------------------------------------------*/
 
 void *pvPortMalloc( size_t xWantedSize )
+{
+ return pvPortMallocFrom( xWantedSize, __builtin_return_address( 0 ) );
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMallocFrom( size_t xWantedSize, void *pvCallSite )
 {
  BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
  void *pvReturn = NULL;
+#ifdef HEAP_TRACE
+ size_t xRequestedSize = xWantedSize;
+#else
+ ( void ) pvCallSite;
+#endif
 
  vTaskSuspendAll();
  {
@@ -243,6 +317,9 @@ void *pvPortMalloc( size_t xWantedSize )
    }
 
    traceMALLOC( pvReturn, xWantedSize );
+#ifdef HEAP_TRACE
+   prvHeapTraceRecord( pvReturn, xRequestedSize, pvCallSite, 0 );
+#endif
  }
  ( void ) xTaskResumeAll();
 
@@ -266,10 +343,20 @@ void *pvPortMalloc( size_t xWantedSize )
 /*-----------------------------------------------------------*/
 
 void vPortFree( void *pv )
+{
+ vPortFreeFrom( pv, __builtin_return_address( 0 ) );
+}
+/*-----------------------------------------------------------*/
+
+void vPortFreeFrom( void *pv, void *pvCallSite )
 {
  uint8_t *puc = ( uint8_t * ) pv;
  BlockLink_t *pxLink;
 
+#ifndef HEAP_TRACE
+ ( void ) pvCallSite;
+#endif
+
  if( pv != NULL )
  {
    /* The memory being freed will have an BlockLink_t structure immediately
@@ -296,7 +383,14 @@ void vPortFree( void *pv )
          /* Add this block to the list of free blocks. */
          xFreeBytesRemaining += pxLink->xBlockSize;
          traceFREE( pv, pxLink->xBlockSize );
+#ifdef HEAP_TRACE
+         /* The size of the block changes if it's merged with its free neighbours */
+         size_t xFreedSize = pxLink->xBlockSize - xHeapStructSize;
+#endif
          prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+#ifdef HEAP_TRACE
+         prvHeapTraceRecord( pv, xFreedSize, pvCallSite, 1 );
+#endif
        }
        ( void ) xTaskResumeAll();
      }
@@ -331,6 +425,21 @@ size_t xPortGetHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
+size_t xPortGetLargestFreeBlockSize( void )
+{
+ size_t xLargestBlockSize = 0;
+
+ vTaskSuspendAll();
+ {
+   xLargestBlockSize = prvLargestFreeBlockSize();
+ }
+ ( void ) xTaskResumeAll();
+
+ /* The header of the block is not available to the application. */
+ return ( xLargestBlockSize > xHeapStructSize ) ? ( xLargestBlockSize - xHeapStructSize ) : 0;
+}
+/*-----------------------------------------------------------*/
+
 void vPortInitialiseBlocks( void )
 {
  /* This just exists to keep the linker quiet. */
@@ -387,9 +496,58 @@ static void prvHeapInit( void )
 
  /* Work out the position of the top bit in a size_t variable. */
  xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
+
+#ifdef HEAP_TRACE
+ xHeapTrace.ulMagic = heapTRACE_MAGIC;
+ xHeapTrace.usVersion = heapTRACE_VERSION;
+ xHeapTrace.usRecordSize = sizeof( HeapTraceRecord_t );
+ xHeapTrace.ulCapacity = HEAP_TRACE_RECORDS;
+ xHeapTrace.ulRecorded = 0;
+ xHeapTrace.ulHeapStart = ( uint32_t ) pucAlignedHeap;
+ xHeapTrace.ulHeapSize = xTotalHeapSize;
+#endif
 }
 /*-----------------------------------------------------------*/
 
+static size_t prvLargestFreeBlockSize( void )
+{
+ BlockLink_t *pxBlock;
+ size_t xLargestBlockSize = 0;
+
+ if( pxEnd != NULL )
+ {
+   for( pxBlock = xStart.pxNextFreeBlock; pxBlock != pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
+   {
+     if( pxBlock->xBlockSize > xLargestBlockSize )
+     {
+       xLargestBlockSize = pxBlock->xBlockSize;
+     }
+   }
+ }
+ return xLargestBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+#ifdef HEAP_TRACE
+static void prvHeapTraceRecord( void *pv, size_t xSize, void *pvCallSite, uint32_t ulIsFree )
+{
+ HeapTraceRecord_t *pxRecord;
+ size_t xLargestBlockSize;
+
+ xLargestBlockSize = prvLargestFreeBlockSize();
+
+ pxRecord = &xHeapTrace.xRecords[ xHeapTrace.ulRecorded % HEAP_TRACE_RECORDS ];
+ pxRecord->ulTimestamp = xTaskGetTickCount();
+ pxRecord->ulCallSite = ( ( uint32_t ) pvCallSite & ~1UL ) | ulIsFree;
+ pxRecord->usOffset = ( pv != NULL ) ? ( uint16_t ) ( ( uint32_t ) pv - xHeapTrace.ulHeapStart ) : heapTRACE_NO_BLOCK;
+ pxRecord->usSize = ( uint16_t ) xSize;
+ pxRecord->usFreeSize = ( uint16_t ) xFreeBytesRemaining;
+ pxRecord->usLargestFreeBlock = ( uint16_t ) ( ( xLargestBlockSize > xHeapStructSize ) ? xLargestBlockSize - xHeapStructSize : 0 );
+ xHeapTrace.ulRecorded++;
+}
+/*-----------------------------------------------------------*/
+#endif
+
 static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert )
 {
  BlockLink_t *pxIterator;
@@ -453,6 +611,10 @@ static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert )
 /*-----------------------------------------------------------*/
 
 void* pvPortRealloc(void* pv, size_t xWantedSize) {
+ return pvPortReallocFrom(pv, xWantedSize, __builtin_return_address(0));
+}
+
+void* pvPortReallocFrom(void* pv, size_t xWantedSize, void* pvCallSite) {
  size_t move_size;
  size_t block_size;
  BlockLink_t* pxLink;
@@ -466,7 +628,7 @@ void* pvPortRealloc(void* pv, size_t xWantedSize) {
 
  if (pv == NULL) {
    // pv points to NULL. Allocate a new buffer.
-   return pvPortMalloc(xWantedSize);
+   return pvPortMallocFrom(xWantedSize, pvCallSite);
  }
 
  // The memory being freed will have an BlockLink_t structure immediately before it.
@@ -481,7 +643,7 @@ void* pvPortRealloc(void* pv, size_t xWantedSize) {
    block_size = (pxLink->xBlockSize & ~xBlockAllocatedBit) - xHeapStructSize;
 
    // Allocate a new buffer
-   pvReturn = pvPortMalloc(xWantedSize);
+   pvReturn = pvPortMallocFrom(xWantedSize, pvCallSite);
 
    // Check creation and determine the data size to be copied to the new buffer
    if (pvReturn != NULL) {
@@ -495,11 +657,11 @@ void* pvPortRealloc(void* pv, size_t xWantedSize) {
      memcpy(pvReturn, pv, move_size);
 
      // Free the old buffer
-     vPortFree(pv);
+     vPortFreeFrom(pv, pvCallSite);
    }
  } else {
    // pv does not point to a valid memory buffer. Allocate a new one
-   pvReturn = pvPortMalloc(xWantedSize);
+   pvReturn = pvPortMallocFrom(xWantedSize, pvCallSite);
  }
 
  return pvReturn;
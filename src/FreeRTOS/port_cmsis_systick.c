@@ -177,6 +177,30 @@ void vPortSetupTimerInterrupt( void )
     NVIC_EnableIRQ(portNRF_RTC_IRQn);
 }
 
+/*
+ * Run time counter used by configGENERATE_RUN_TIME_STATS: the 24 bits RTC counter
+ * extended to 32 bits. The kernel reads it at each context switch, and tickless idle
+ * never sleeps for more than portNRF_RTC_MAXTICKS, so at most one overflow can occur
+ * between two consecutive calls.
+ */
+uint32_t ulPortGetRunTimeCounterValue( void )
+{
+    static uint32_t ulOverflows = 0;
+    static uint32_t ulPreviousCounter = 0;
+
+    UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t ulCounter = nrf_rtc_counter_get(portNRF_RTC_REG);
+    if (ulCounter < ulPreviousCounter)
+    {
+        ulOverflows++;
+    }
+    ulPreviousCounter = ulCounter;
+    uint32_t ulValue = (ulOverflows * (portNRF_RTC_MAXTICKS + 1U)) + ulCounter;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSavedInterruptStatus);
+
+    return ulValue;
+}
+
 #if configUSE_TICKLESS_IDLE == 1
 void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
 {
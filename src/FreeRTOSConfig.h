@@ -83,10 +83,15 @@
 #define configUSE_MALLOC_FAILED_HOOK   1
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS        0
+#define configGENERATE_RUN_TIME_STATS        1
 #define configUSE_TRACE_FACILITY             1
 #define configUSE_STATS_FORMATTING_FUNCTIONS 0
 
+/* The run time counter is the RTC used as tick source, extended to 32 bits (see port_cmsis_systick.c).
+ * It keeps counting while the CPU sleeps, so the time spent in tickless idle is accounted to the idle task. */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() ulPortGetRunTimeCounterValue()
+
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES           0
 #define configMAX_CO_ROUTINE_PRIORITIES (2)
@@ -185,6 +190,15 @@ standard names - or at least those used in the unmodified vector table. */
     #include <stdint.h>
 extern uint32_t SystemCoreClock;
   #endif
+
+  #include <stdint.h>
+  #ifdef __cplusplus
+extern "C" {
+  #endif
+uint32_t ulPortGetRunTimeCounterValue(void);
+  #ifdef __cplusplus
+}
+  #endif
 #endif /* !assembler */
 
 /** Implementation note:  Use this with caution and set this to 1 ONLY for debugging
@@ -1,12 +1,31 @@
 #include "components/ble/DfuService.h"
+#include <array>
 #include <cstring>
 #include "components/ble/BleController.h"
 #include "drivers/SpiNorFlash.h"
 #include "systemtask/SystemTask.h"
 #include <nrf_log.h>
+#include <host/ble_att.h>
 
 using namespace Pinetime::Controllers;
 
+namespace {
+  // CRC-16/CCITT (polynomial 0x1021), processed one byte at a time
+  constexpr std::array<uint16_t, 256> GenerateCrcTable() {
+    std::array<uint16_t, 256> table {};
+    for (uint16_t i = 0; i < table.size(); i++) {
+      uint16_t crc = i << 8;
+      for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+      }
+      table[i] = crc;
+    }
+    return table;
+  }
+
+  constexpr std::array<uint16_t, 256> crcTable = GenerateCrcTable();
+}
+
 constexpr ble_uuid128_t DfuService::serviceUuid;
 constexpr ble_uuid128_t DfuService::controlPointCharacteristicUuid;
 constexpr ble_uuid128_t DfuService::revisionCharacteristicUuid;
@@ -163,8 +182,21 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
 
     case States::Data: {
       nbPacketReceived++;
-      dfuImage.Append(om->om_data, om->om_len);
-      bytesReceived += om->om_len;
+      // Packets larger than an mbuf (large MTU) are received as a chain of mbufs
+      for (os_mbuf* fragment = om; fragment != nullptr; fragment = SLIST_NEXT(fragment, om_next)) {
+        if (!dfuImage.Append(fragment->om_data, fragment->om_len)) {
+          // The packet doesn't fit in the image announced by the host, don't write it past the end of the image
+          NRF_LOG_INFO("[DFU] -> Packet of %d bytes at %d exceeds the image size", fragment->om_len, bytesReceived);
+          uint8_t data[3] {static_cast<uint8_t>(Opcodes::Response),
+                           static_cast<uint8_t>(Opcodes::ReceiveFirmwareImage),
+                           static_cast<uint8_t>(ErrorCodes::DataSizeExceedsLimits)};
+          notificationManager.Send(connectionHandle, controlPointCharacteristicHandle, data, 3);
+          bleController.State(Pinetime::Controllers::Ble::FirmwareUpdateStates::Error);
+          Reset();
+          return 0;
+        }
+        bytesReceived += fragment->om_len;
+      }
       bleController.FirmwareUpdateCurrentBytes(bytesReceived);
 
       if ((nbPacketReceived % nbPacketsToNotify) == 0 && bytesReceived != applicationSize) {
@@ -248,8 +280,9 @@ int DfuService::ControlPointHandler(uint16_t connectionHandle, os_mbuf* om) {
         NRF_LOG_INFO("[DFU] -> Receive firmware image requested, but we are not in Start Init");
         return 0;
       }
-      // TODO the chunk size is dependent of the implementation of the host application...
-      dfuImage.Init(20, applicationSize, expectedCrc);
+      // The host sizes the packets according to the negotiated ATT MTU, Append() accepts any size
+      NRF_LOG_INFO("[DFU] -> ATT MTU : %d", ble_att_mtu(connectionHandle));
+      dfuImage.Init(applicationSize, expectedCrc);
       NRF_LOG_INFO("[DFU] -> Starting receive firmware");
       state = States::Data;
       return 0;
@@ -352,37 +385,32 @@ void DfuService::NotificationManager::Reset() {
   xTimerStop(timer, 0);
 }
 
-void DfuService::DfuImage::Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc) {
-  if (chunkSize != 20)
+void DfuService::DfuImage::Init(size_t totalSize, uint16_t expectedCrc) {
+  ready = false;
+  if (totalSize > maxSize)
     return;
-  this->chunkSize = chunkSize;
   this->totalSize = totalSize;
   this->expectedCrc = expectedCrc;
   this->ready = true;
   totalWriteIndex = 0;
-  bufferWriteIndex = 0;
+  crc = 0xFFFF;
 }
 
-void DfuService::DfuImage::Append(uint8_t* data, size_t size) {
-  if (!ready)
-    return;
-  ASSERT(size <= 20);
+bool DfuService::DfuImage::Append(uint8_t* data, size_t size) {
+  if (!ready || size > totalSize - totalWriteIndex)
+    return false;
 
-  std::memcpy(tempBuffer + bufferWriteIndex, data, size);
-  bufferWriteIndex += size;
+  // SpiNorFlash gathers the packets into full pages before programming them
+  crc = ComputeCrc(data, size, &crc);
+  spiNorFlash.Write(writeOffset + totalWriteIndex, data, size);
+  totalWriteIndex += size;
 
-  if (bufferWriteIndex == bufferSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
-    bufferWriteIndex = 0;
-  }
-
-  if (bufferWriteIndex > 0 && totalWriteIndex + bufferWriteIndex == totalSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
+  if (totalWriteIndex == totalSize) {
     if (totalSize < maxSize)
       WriteMagicNumber();
+    spiNorFlash.Flush();
   }
+  return true;
 }
 
 void DfuService::DfuImage::WriteMagicNumber() {
@@ -405,35 +433,43 @@ void DfuService::DfuImage::Erase() {
 }
 
 bool DfuService::DfuImage::Validate() {
-  uint32_t chunkSize = 200;
-  size_t currentOffset = 0;
-  uint16_t crc = 0;
-
-  bool first = true;
-  while (currentOffset < totalSize) {
-    uint32_t readSize = (totalSize - currentOffset) > chunkSize ? chunkSize : (totalSize - currentOffset);
-
-    spiNorFlash.Read(writeOffset + currentOffset, tempBuffer, readSize);
-    if (first) {
-      crc = ComputeCrc(tempBuffer, readSize, NULL);
-      first = false;
-    } else
-      crc = ComputeCrc(tempBuffer, readSize, &crc);
-    currentOffset += readSize;
+  if (crc != expectedCrc) {
+    return false;
+  }
+
+  // Only the failures in the area of the image, littlefs gets its own
+  if (spiNorFlash.EraseFailed(writeOffset, maxSize) || spiNorFlash.ProgramFailed(writeOffset, maxSize)) {
+    return false;
   }
 
-  return (crc == expectedCrc);
+  if constexpr (readBackVerification) {
+    // Make sure the image was correctly programmed in the external flash
+    spiNorFlash.Flush();
+    TickType_t start = xTaskGetTickCount();
+    uint32_t chunkSize = bufferSize;
+    size_t currentOffset = 0;
+    uint16_t readBackCrc = 0xFFFF;
+    while (currentOffset < totalSize) {
+      uint32_t readSize = (totalSize - currentOffset) > chunkSize ? chunkSize : (totalSize - currentOffset);
+
+      spiNorFlash.Read(writeOffset + currentOffset, tempBuffer, readSize);
+      readBackCrc = ComputeCrc(tempBuffer, readSize, &readBackCrc);
+      currentOffset += readSize;
+    }
+    NRF_LOG_INFO("[DFU] Read-back verification of %d bytes in %d ms",
+                 totalSize,
+                 (xTaskGetTickCount() - start) * 1000 / configTICK_RATE_HZ);
+    return readBackCrc == expectedCrc;
+  }
+
+  return true;
 }
 
 uint16_t DfuService::DfuImage::ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc) {
   uint16_t crc = (p_crc == NULL) ? 0xFFFF : *p_crc;
 
   for (uint32_t i = 0; i < size; i++) {
-    crc = static_cast<uint8_t>(crc >> 8) | (crc << 8);
-    crc ^= p_data[i];
-    crc ^= static_cast<uint8_t>(crc & 0xFF) >> 4;
-    crc ^= (crc << 8) << 4;
-    crc ^= ((crc & 0xFF) << 4) << 1;
+    crc = (crc << 8) ^ crcTable[static_cast<uint8_t>(crc >> 8) ^ p_data[i]];
   }
 
   return crc;
@@ -54,9 +54,10 @@ namespace Pinetime {
         DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash} {
         }
 
-        void Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc);
+        void Init(size_t totalSize, uint16_t expectedCrc);
         void Erase();
-        void Append(uint8_t* data, size_t size);
+        // Returns false, without writing anything, if the data doesn't fit in the image
+        bool Append(uint8_t* data, size_t size);
         bool Validate();
         bool IsComplete();
 
@@ -64,17 +65,23 @@ namespace Pinetime {
         Pinetime::Drivers::SpiNorFlash& spiNorFlash;
         static constexpr size_t bufferSize = 200;
         bool ready = false;
-        size_t chunkSize = 0;
         size_t totalSize = 0;
         size_t maxSize = 475136;
-        size_t bufferWriteIndex = 0;
         size_t totalWriteIndex = 0;
         static constexpr size_t writeOffset = 0x40000;
         uint8_t tempBuffer[bufferSize];
         uint16_t expectedCrc = 0;
+        // CRC of the data received so far, updated by Append()
+        uint16_t crc = 0xFFFF;
+        // Also compute the CRC of the image read back from the flash in Validate(), enabled with -DDFU_READ_BACK=1
+#ifdef DFU_READ_BACK
+        static constexpr bool readBackVerification = true;
+#else
+        static constexpr bool readBackVerification = false;
+#endif
 
         void WriteMagicNumber();
-        uint16_t ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc);
+        static uint16_t ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc);
       };
 
       static constexpr ble_uuid128_t serviceUuid {
@@ -0,0 +1,57 @@
+#include "components/ble/DiagnosticService.h"
+#include "systemtask/SystemTask.h"
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // 0006yyxx-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t CharUuid(uint8_t x, uint8_t y) {
+    return ble_uuid128_t {.u = {.type = BLE_UUID_TYPE_128},
+                          .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, x, y, 0x06, 0x00}};
+  }
+
+  // 00060000-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t BaseUuid() {
+    return CharUuid(0x00, 0x00);
+  }
+
+  constexpr ble_uuid128_t diagnosticServiceUuid {BaseUuid()};
+  constexpr ble_uuid128_t samplesCharUuid {CharUuid(0x01, 0x00)};
+
+  int DiagnosticServiceCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
+    auto* diagnosticService = static_cast<DiagnosticService*>(arg);
+    return diagnosticService->OnSamplesRequested(attr_handle, ctxt);
+  }
+}
+
+DiagnosticService::DiagnosticService(Pinetime::System::SystemTask& systemTask)
+  : systemTask {systemTask},
+    characteristicDefinition {{.uuid = &samplesCharUuid.u,
+                               .access_cb = DiagnosticServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &samplesHandle},
+                              {0}},
+    serviceDefinition {
+      {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &diagnosticServiceUuid.u, .characteristics = characteristicDefinition},
+      {0},
+    } {
+}
+
+void DiagnosticService::Init() {
+  int res = 0;
+  res = ble_gatts_count_cfg(serviceDefinition);
+  ASSERT(res == 0);
+
+  res = ble_gatts_add_svcs(serviceDefinition);
+  ASSERT(res == 0);
+}
+
+int DiagnosticService::OnSamplesRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
+  if (attributeHandle == samplesHandle && context->op == BLE_GATT_ACCESS_OP_READ_CHR) {
+    size_t nbSamples = systemTask.Monitor().GetSamples(samples.data(), samples.size());
+    int res = os_mbuf_append(context->om, samples.data(), nbSamples * sizeof(Pinetime::System::SystemMonitor::Sample));
+    return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
+  return 0;
+}
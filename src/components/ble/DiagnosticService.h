@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#define min // workaround: nimble's min/max macros conflict with libstdc++
+#define max
+#include <host/ble_gap.h>
+#include <host/ble_att.h>
+#undef max
+#undef min
+#include "systemtask/SystemMonitor.h"
+
+namespace Pinetime {
+  namespace System {
+    class SystemTask;
+  }
+
+  namespace Controllers {
+    // Exposes the samples recorded by the SystemMonitor (CPU usage per task, heap, queue depths, interrupt counts,
+    // time spent in each power state and system task wakeups) as an array of SystemMonitor::Sample, oldest first.
+    class DiagnosticService {
+    public:
+      explicit DiagnosticService(Pinetime::System::SystemTask& systemTask);
+      void Init();
+
+      int OnSamplesRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context);
+
+    private:
+      Pinetime::System::SystemTask& systemTask;
+
+      struct ble_gatt_chr_def characteristicDefinition[2];
+      struct ble_gatt_svc_def serviceDefinition[2];
+
+      uint16_t samplesHandle;
+      std::array<Pinetime::System::SystemMonitor::Sample, Pinetime::System::SystemMonitor::nbSamples> samples;
+      static_assert(sizeof(samples) <= BLE_ATT_ATTR_MAX_LEN, "The samples don't fit in the characteristic");
+    };
+  }
+}
@@ -1,5 +1,8 @@
 #include <nrf_log.h>
 #include "FSService.h"
+#include <algorithm>
+#include <cstring>
+#include <host/ble_att.h>
 #include "components/ble/BleController.h"
 #include "systemtask/SystemTask.h"
 
@@ -82,62 +85,13 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       }
       memcpy(filepath, header->pathstr, plen);
       filepath[plen] = 0; // Copy and null terminate string
-      ReadResponse resp;
-      os_mbuf* om;
-      resp.command = commands::READ_DATA;
-      resp.status = 0x01;
-      resp.chunkoff = header->chunkoff;
-      int res = fs.Stat(filepath, &info);
-      if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
-        resp.status = (int8_t) res;
-        resp.chunklen = 0;
-        resp.totallen = 0;
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-      } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
-        resp.totallen = info.size;
-        fs.FileOpen(&f, filepath, LFS_O_RDONLY);
-        fs.FileSeek(&f, header->chunkoff);
-        uint8_t fileData[resp.chunklen] = {0};
-        resp.chunklen = fs.FileRead(&f, fileData, resp.chunklen);
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-        os_mbuf_append(om, fileData, resp.chunklen);
-        fs.FileClose(&f);
-      }
-
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      StreamFile(connectionHandle, header->chunkoff, header->chunksize);
       break;
     }
     case commands::READ_PACING: {
       NRF_LOG_INFO("[FS_S] -> Readpacing");
       auto* header = (ReadHeader*) om->om_data;
-      ReadResponse resp;
-      resp.command = commands::READ_DATA;
-      resp.status = 0x01;
-      resp.chunkoff = header->chunkoff;
-      int res = fs.Stat(filepath, &info);
-      if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
-        resp.status = (int8_t) res;
-        resp.chunklen = 0;
-        resp.totallen = 0;
-      } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
-        resp.totallen = info.size;
-        fs.FileOpen(&f, filepath, LFS_O_RDONLY);
-        fs.FileSeek(&f, header->chunkoff);
-      }
-      os_mbuf* om;
-      if (resp.chunklen > 0) {
-        uint8_t fileData[resp.chunklen] = {0};
-        resp.chunklen = fs.FileRead(&f, fileData, resp.chunklen);
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-        os_mbuf_append(om, fileData, resp.chunklen);
-      } else {
-        resp.chunklen = 0;
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-      }
-      fs.FileClose(&f);
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      StreamFile(connectionHandle, header->chunkoff, header->chunksize);
       break;
     }
     case commands::WRITE: {
@@ -150,6 +104,10 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       memcpy(filepath, header->pathstr, plen);
       filepath[plen] = 0; // Copy and null terminate string
       fileSize = header->totalSize;
+      // The index of the resource pack points into the file that is about to be overwritten
+      if (strcmp(filepath, ResourcePack::path) == 0) {
+        fs.GetResourcePack().Invalidate();
+      }
       WriteResponse resp;
       resp.command = commands::WRITE_PACING;
       resp.offset = header->offset;
@@ -179,6 +137,10 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
         }
         fs.FileClose(&f);
       }
+      // Serve the resources from the new pack once it's completely written
+      if (res >= 0 && header->offset + header->dataSize >= fileSize && strcmp(filepath, ResourcePack::path) == 0) {
+        systemTask.PushMessage(Pinetime::System::Messages::ResourcePackChanged);
+      }
       if (res < 0) {
         resp.status = (int8_t) res;
       }
@@ -196,8 +158,15 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       path[plen] = 0; // Copy and null terminate string
       DelResponse resp {};
       resp.command = commands::DELETE_STATUS;
+      const bool isResourcePack = strcmp(path, ResourcePack::path) == 0;
+      if (isResourcePack) {
+        fs.GetResourcePack().Invalidate();
+      }
       int res = fs.FileDelete(path);
       resp.status = (res == 0) ? 0x01 : (int8_t) res;
+      if (isResourcePack) {
+        systemTask.PushMessage(Pinetime::System::Messages::ResourcePackChanged);
+      }
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(DelResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
       break;
@@ -264,14 +233,9 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
 
         // strcpy(resp.path, info.name);
         resp.path_length = strlen(info.name);
-        auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(ListDirResponse));
-        os_mbuf_append(om, info.name, resp.path_length);
-        ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
-        /*
-         * Todo Figure out how to know when the previous Notify was TX'd
-         * For now just delay 100ms to make sure that the data went out...
-         */
-        vTaskDelay(100); // Allow stuff to actually go out over the BLE conn
+        if (!Notify(connectionHandle, &resp, sizeof(ListDirResponse), info.name, resp.path_length)) {
+          break;
+        }
         resp.entry++;
       }
       assert(fs.DirClose(&dir) == 0);
@@ -293,8 +257,15 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       path[header->NewPathLength] = 0; // Copy and null terminate string
       MoveResponse resp {};
       resp.command = commands::MOVE_STATUS;
+      const bool isResourcePack = strcmp(header->pathstr, ResourcePack::path) == 0 || strcmp(path, ResourcePack::path) == 0;
+      if (isResourcePack) {
+        fs.GetResourcePack().Invalidate();
+      }
       int8_t res = (int8_t) fs.Rename(header->pathstr, path);
       resp.status = (res == 0) ? 1 : res;
+      if (isResourcePack) {
+        systemTask.PushMessage(Pinetime::System::Messages::ResourcePackChanged);
+      }
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(MoveResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
     }
@@ -306,6 +277,80 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
   return 0;
 }
 
+// Sends the requested part of the file as a window of MTU-sized READ_DATA notifications, without waiting
+// for the client between them. The client sends READ_PACING for the next window once it has received this one.
+// The window is capped to maxWindowSize so that the host task isn't kept in this callback for too long.
+void FSService::StreamFile(uint16_t connectionHandle, uint32_t offset, uint32_t windowSize) {
+  ReadResponse resp {};
+  resp.command = commands::READ_DATA;
+  resp.status = 0x01;
+  resp.chunkoff = offset;
+
+  lfs_info info {};
+  int res = fs.Stat(filepath, &info);
+  if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
+    resp.status = (int8_t) res;
+    resp.chunklen = 0;
+    resp.totallen = 0;
+    Notify(connectionHandle, &resp, sizeof(ReadResponse), nullptr, 0);
+    return;
+  }
+
+  resp.totallen = info.size;
+  lfs_file_t f {};
+  fs.FileOpen(&f, filepath, LFS_O_RDONLY);
+  fs.FileSeek(&f, offset);
+
+  const uint16_t mtu = ble_att_mtu(connectionHandle);
+  size_t maxChunkLength = readBuffer.size();
+  if (mtu > notificationOverhead + sizeof(ReadResponse)) {
+    maxChunkLength = std::min<size_t>(maxChunkLength, mtu - notificationOverhead - sizeof(ReadResponse));
+  }
+
+  windowSize = std::min(windowSize, maxWindowSize);
+  uint32_t remaining = (offset < info.size) ? std::min(windowSize, info.size - offset) : 0;
+  do {
+    int chunkLength = 0;
+    if (remaining > 0) {
+      chunkLength = std::max(0, fs.FileRead(&f, readBuffer.data(), std::min<uint32_t>(remaining, maxChunkLength)));
+    }
+    resp.chunklen = chunkLength;
+    if (!Notify(connectionHandle, &resp, sizeof(ReadResponse), readBuffer.data(), chunkLength)) {
+      break;
+    }
+
+    if (chunkLength == 0) {
+      break;
+    }
+    resp.chunkoff += chunkLength;
+    remaining -= chunkLength;
+  } while (remaining > 0);
+
+  fs.FileClose(&f);
+}
+
+bool FSService::Notify(uint16_t connectionHandle, const void* header, size_t headerSize, const void* data, size_t dataSize) {
+  // Notifications are not acknowledged: wait only while the controller has not sent enough of the previous ones
+  // to leave some mbufs for the rest of the stack. Give up if they are not sent (link lost, client not reading).
+  const TickType_t start = xTaskGetTickCount();
+  while (os_msys_num_free() < minFreeMbufs) {
+    if (xTaskGetTickCount() - start > maxNotifyDelay) {
+      return false;
+    }
+    vTaskDelay(1);
+  }
+
+  auto* om = ble_hs_mbuf_from_flat(header, headerSize);
+  if (om == nullptr) {
+    return false;
+  }
+  if (dataSize > 0 && os_mbuf_append(om, data, dataSize) != 0) {
+    os_mbuf_free_chain(om);
+    return false;
+  }
+  return ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om) == 0;
+}
+
 // Loads resp with file data given a valid filepath header and resp
 void FSService::prepareReadDataResp(ReadHeader* header, ReadResponse* resp) {
   // uint16_t plen = header->pathlen;
@@ -5,6 +5,7 @@
 #undef max
 #undef min
 
+#include <array>
 #include "components/fs/FS.h"
 
 namespace Pinetime {
@@ -190,7 +191,19 @@ namespace Pinetime {
         uint8_t status;
       };
 
+      // ATT notification header (opcode + handle)
+      static constexpr size_t notificationOverhead = 3;
+      static constexpr size_t maxNotificationSize = MYNEWT_VAL(BLE_ATT_PREFERRED_MTU) - notificationOverhead;
+      static constexpr int minFreeMbufs = 4;
+      // Largest window sent for a single READ or READ_PACING command
+      static constexpr uint32_t maxWindowSize = 2048;
+      // Longest wait for the controller to send the previous notifications (ticks)
+      static constexpr uint32_t maxNotifyDelay = 500;
+      std::array<uint8_t, maxNotificationSize - sizeof(ReadResponse)> readBuffer;
+
       int FSCommandHandler(uint16_t connectionHandle, os_mbuf* om);
+      void StreamFile(uint16_t connectionHandle, uint32_t offset, uint32_t windowSize);
+      bool Notify(uint16_t connectionHandle, const void* header, size_t headerSize, const void* data, size_t dataSize);
       void prepareReadDataResp(ReadHeader* header, ReadResponse* resp);
     };
   }
@@ -14,6 +14,7 @@
 #include "components/ble/CurrentTimeService.h"
 #include "components/ble/DeviceInformationService.h"
 #include "components/ble/DfuService.h"
+#include "components/ble/DiagnosticService.h"
 #include "components/ble/FSService.h"
 #include "components/ble/HeartRateService.h"
 #include "components/ble/ImmediateAlertService.h"
@@ -106,6 +107,7 @@ namespace Pinetime {
       HeartRateService heartRateService;
       MotionService motionService;
       FSService fsService;
+      DiagnosticService diagnosticService;
       ServiceDiscovery serviceDiscovery;
 
       uint8_t addrType;
@@ -13,6 +13,14 @@ namespace {
   constexpr const char* const MonthsStringLow[] =
     {"--", "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
 
+  // Handles the overflow of the RTC counter
+  uint32_t TicksElapsed(uint32_t from, uint32_t to) {
+    if (to < from) {
+      return static_cast<uint32_t>(portNRF_RTC_MAXTICKS) - from + to + 1;
+    }
+    return to - from;
+  }
+
   constexpr int compileTimeAtoi(const char* str) {
     int result = 0;
     while (*str >= '0' && *str <= '9') {
@@ -34,8 +42,10 @@ DateTime::DateTime(Controllers::Settings& settingsController) : settingsControll
 
 void DateTime::SetCurrentTime(std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> t) {
   xSemaphoreTake(mutex, portMAX_DELAY);
-  this->currentDateTime = t;
-  UpdateTime(previousSystickCounter, true); // Update internal state without updating the time
+  State newState = state;
+  newState.systickCounter = nrf_rtc_counter_get(portNRF_RTC_REG);
+  newState.dateTime = t;
+  UpdateTime(newState, newState.systickCounter, true); // Update internal state without updating the time
   xSemaphoreGive(mutex);
 }
 
@@ -55,8 +65,10 @@ void DateTime::SetTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour,
   tm.tm_isdst = -1; // Use DST value from local time zone
 
   xSemaphoreTake(mutex, portMAX_DELAY);
-  currentDateTime = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-  UpdateTime(previousSystickCounter, true);
+  State newState = state;
+  newState.systickCounter = nrf_rtc_counter_get(portNRF_RTC_REG);
+  newState.dateTime = std::chrono::system_clock::from_time_t(std::mktime(&tm));
+  UpdateTime(newState, newState.systickCounter, true);
   xSemaphoreGive(mutex);
 
   if (systemTask != nullptr) {
@@ -70,21 +82,48 @@ void DateTime::SetTimeZone(int8_t timezone, int8_t dst) {
 }
 
 std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> DateTime::CurrentDateTime() {
-  xSemaphoreTake(mutex, portMAX_DELAY);
-  UpdateTime(nrf_rtc_counter_get(portNRF_RTC_REG), false);
-  xSemaphoreGive(mutex);
-  return currentDateTime;
+  uint32_t systickCounter;
+  State current = ReadState(systickCounter);
+  uint32_t elapsed = TicksElapsed(current.systickCounter, systickCounter);
+
+  if (elapsed >= configTICK_RATE_HZ) {
+    // A new second has started: the first caller updates the broken down time and sends the notifications
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    UpdateTime(state, nrf_rtc_counter_get(portNRF_RTC_REG), false);
+    xSemaphoreGive(mutex);
+
+    current = ReadState(systickCounter);
+    elapsed = TicksElapsed(current.systickCounter, systickCounter);
+  }
+
+  return current.dateTime + std::chrono::nanoseconds((static_cast<uint64_t>(elapsed) * 1000000000) / configTICK_RATE_HZ);
 }
 
-void DateTime::UpdateTime(uint32_t systickCounter, bool forceUpdate) {
-  // Handle systick counter overflow
-  uint32_t systickDelta = 0;
-  if (systickCounter < previousSystickCounter) {
-    systickDelta = static_cast<uint32_t>(portNRF_RTC_MAXTICKS) - previousSystickCounter;
-    systickDelta += systickCounter + 1;
-  } else {
-    systickDelta = systickCounter - previousSystickCounter;
-  }
+DateTime::State DateTime::ReadState(uint32_t& systickCounter) const {
+  // The RTC counter is read within the sequence so that it's never older than the state
+  State snapshot;
+  uint32_t before;
+  do {
+    before = sequence.load(std::memory_order_acquire);
+    snapshot = state;
+    systickCounter = nrf_rtc_counter_get(portNRF_RTC_REG);
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((before & 1u) != 0 || sequence.load(std::memory_order_relaxed) != before);
+  return snapshot;
+}
+
+void DateTime::PublishState(const State& newState) {
+  // The writer is not preempted while the sequence is odd, readers only retry if they were interrupted by the writer
+  taskENTER_CRITICAL();
+  sequence.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  state = newState;
+  sequence.fetch_add(1, std::memory_order_release);
+  taskEXIT_CRITICAL();
+}
+
+void DateTime::UpdateTime(State newState, uint32_t systickCounter, bool forceUpdate) {
+  uint32_t systickDelta = TicksElapsed(newState.systickCounter, systickCounter);
 
   auto correctedDelta = systickDelta / configTICK_RATE_HZ;
   // If a second hasn't passed, there is nothing to do
@@ -94,16 +133,17 @@ void DateTime::UpdateTime(uint32_t systickCounter, bool forceUpdate) {
   }
   auto rest = systickDelta % configTICK_RATE_HZ;
   if (systickCounter >= rest) {
-    previousSystickCounter = systickCounter - rest;
+    newState.systickCounter = systickCounter - rest;
   } else {
-    previousSystickCounter = static_cast<uint32_t>(portNRF_RTC_MAXTICKS) - (rest - systickCounter - 1);
+    newState.systickCounter = static_cast<uint32_t>(portNRF_RTC_MAXTICKS) - (rest - systickCounter - 1);
   }
 
-  currentDateTime += std::chrono::seconds(correctedDelta);
-  uptime += std::chrono::seconds(correctedDelta);
+  newState.dateTime += std::chrono::seconds(correctedDelta);
+  newState.uptime += std::chrono::seconds(correctedDelta);
 
-  std::time_t currentTime = std::chrono::system_clock::to_time_t(currentDateTime);
-  localTime = *std::localtime(&currentTime);
+  std::time_t currentTime = std::chrono::system_clock::to_time_t(newState.dateTime);
+  newState.localTime = *std::localtime(&currentTime);
+  PublishState(newState);
 
   auto minute = Minutes();
   auto hour = Hours();
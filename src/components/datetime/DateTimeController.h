@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <chrono>
 #include <ctime>
@@ -48,19 +49,19 @@ namespace Pinetime {
       void SetTimeZone(int8_t timezone, int8_t dst);
 
       uint16_t Year() const {
-        return 1900 + localTime.tm_year;
+        return 1900 + state.localTime.tm_year;
       }
 
       Months Month() const {
-        return static_cast<Months>(localTime.tm_mon + 1);
+        return static_cast<Months>(state.localTime.tm_mon + 1);
       }
 
       uint8_t Day() const {
-        return localTime.tm_mday;
+        return state.localTime.tm_mday;
       }
 
       Days DayOfWeek() const {
-        int daysSinceSunday = localTime.tm_wday;
+        int daysSinceSunday = state.localTime.tm_wday;
         if (daysSinceSunday == 0) {
           return Days::Sunday;
         }
@@ -68,19 +69,19 @@ namespace Pinetime {
       }
 
       int DayOfYear() const {
-        return localTime.tm_yday + 1;
+        return state.localTime.tm_yday + 1;
       }
 
       uint8_t Hours() const {
-        return localTime.tm_hour;
+        return state.localTime.tm_hour;
       }
 
       uint8_t Minutes() const {
-        return localTime.tm_min;
+        return state.localTime.tm_min;
       }
 
       uint8_t Seconds() const {
-        return localTime.tm_sec;
+        return state.localTime.tm_sec;
       }
 
       /*
@@ -131,7 +132,8 @@ namespace Pinetime {
       }
 
       std::chrono::seconds Uptime() const {
-        return uptime;
+        uint32_t systickCounter;
+        return ReadState(systickCounter).uptime;
       }
 
       void Register(System::SystemTask* systemTask);
@@ -139,18 +141,27 @@ namespace Pinetime {
       std::string FormattedTime();
 
     private:
-      void UpdateTime(uint32_t systickCounter, bool forceUpdate);
+      // Written by a single writer at a time (under mutex) and published with a sequence lock,
+      // so that readers never have to take the mutex
+      struct State {
+        // Value of the RTC counter at the beginning of the current second
+        uint32_t systickCounter = 0;
+        std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> dateTime;
+        std::chrono::seconds uptime {0};
+        std::tm localTime {};
+      };
+
+      State ReadState(uint32_t& systickCounter) const;
+      void PublishState(const State& newState);
+      void UpdateTime(State newState, uint32_t systickCounter, bool forceUpdate);
 
-      std::tm localTime;
+      State state;
+      std::atomic<uint32_t> sequence {0};
       int8_t tzOffset = 0;
       int8_t dstOffset = 0;
 
       SemaphoreHandle_t mutex = nullptr;
 
-      uint32_t previousSystickCounter = 0;
-      std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> currentDateTime;
-      std::chrono::seconds uptime {0};
-
       bool isMidnightAlreadyNotified = false;
       bool isHourAlreadyNotified = true;
       bool isHalfHourAlreadyNotified = true;
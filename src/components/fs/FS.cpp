@@ -7,6 +7,7 @@ using namespace Pinetime::Controllers;
 
 FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
   : flashDriver {driver},
+    readCache {driver},
     lfsConfig {
       .context = this,
       .read = SectorRead,
@@ -49,8 +50,8 @@ void FS::Init() {
 }
 
 void FS::VerifyResource() {
-  // validate the resource metadata
-  resourcesValid = true;
+  // Reloads the index of the resource pack, without the resources that don't match their CRC
+  resourcesValid = resourcePack.Load();
 }
 
 int FS::FileOpen(lfs_file_t* file_p, const char* fileName, const int flags) {
@@ -114,27 +115,31 @@ lfs_ssize_t FS::GetFSSize() {
     ----------- Interface between littlefs and SpiNorFlash -----------
 
 */
-int FS::SectorSync(const struct lfs_config* /*c*/) {
-  return 0;
+int FS::SectorSync(const struct lfs_config* c) {
+  Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
+  return lfs.flashDriver.ProgramFailed(startAddress, size) ? -1 : 0;
 }
 
 int FS::SectorErase(const struct lfs_config* c, lfs_block_t block) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize);
+  lfs.readCache.Invalidate(address, blockSize);
   lfs.flashDriver.SectorErase(address);
-  return lfs.flashDriver.EraseFailed() ? -1 : 0;
+  return lfs.flashDriver.EraseFailed(address, blockSize) ? -1 : 0;
 }
 
 int FS::SectorProg(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buffer, lfs_size_t size) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize) + off;
+  lfs.readCache.Invalidate(address, size);
+  // Programming errors are reported by SectorSync(), once the pages gathered by the driver have been written
   lfs.flashDriver.Write(address, (uint8_t*) buffer, size);
-  return lfs.flashDriver.ProgramFailed() ? -1 : 0;
+  return 0;
 }
 
 int FS::SectorRead(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buffer, lfs_size_t size) {
   Pinetime::Controllers::FS& lfs = *(static_cast<Pinetime::Controllers::FS*>(c->context));
   const size_t address = startAddress + (block * blockSize) + off;
-  lfs.flashDriver.Read(address, static_cast<uint8_t*>(buffer), size);
+  lfs.readCache.Read(address, static_cast<uint8_t*>(buffer), size);
   return 0;
 }
@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include "drivers/SpiNorFlash.h"
+#include "components/fs/ReadCache.h"
+#include "components/fs/ResourcePack.h"
 #include <littlefs/lfs.h>
 
 namespace Pinetime {
@@ -31,6 +33,10 @@ namespace Pinetime {
       int Stat(const char* path, lfs_info* info);
       void VerifyResource();
 
+      ResourcePack& GetResourcePack() {
+        return resourcePack;
+      }
+
       static size_t getSize() {
         return size;
       }
@@ -39,8 +45,18 @@ namespace Pinetime {
         return blockSize;
       }
 
+      static constexpr size_t readCacheNbLines = 4;
+      static constexpr size_t readCacheLineSize = 256;
+      using FlashReadCache = ReadCache<readCacheNbLines, readCacheLineSize>;
+
+      // Since boot, logged by DisplayApp on each screen change
+      const FlashReadCache::Statistics& GetReadCacheStatistics() const {
+        return readCache.GetStatistics();
+      }
+
     private:
       Pinetime::Drivers::SpiNorFlash& flashDriver;
+      FlashReadCache readCache;
 
       /*
        * External Flash MAP (4 MBytes)
@@ -69,6 +85,7 @@ namespace Pinetime {
       static constexpr size_t blockSize = 4096;
 
       bool resourcesValid = false;
+      ResourcePack resourcePack {*this};
       const struct lfs_config lfsConfig;
 
       lfs_t lfs;
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "drivers/SpiNorFlash.h"
+
+namespace Pinetime {
+  namespace Controllers {
+    /* Read cache in front of the external SPI flash.
+     * Small reads are served from NbLines lines of LineSize bytes, each of them filled with a single SPI transaction
+     * (the bytes following the requested ones are read ahead, as littlefs mostly reads sequentially).
+     * Reads of at least one line go directly to the flash. The least recently used line is evicted on miss.
+     * The cache never holds data to write: Invalidate() must be called before the flash is programmed or erased.
+     */
+    template <size_t NbLines, size_t LineSize>
+    class ReadCache {
+      static_assert((LineSize & (LineSize - 1)) == 0, "LineSize must be a power of 2");
+
+    public:
+      struct Statistics {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t bypasses = 0;
+      };
+
+      explicit ReadCache(Pinetime::Drivers::SpiNorFlash& flashDriver) : flashDriver {flashDriver} {
+      }
+
+      void Read(uint32_t address, uint8_t* buffer, size_t size) {
+        if (size >= LineSize) {
+          statistics.bypasses++;
+          flashDriver.Read(address, buffer, size);
+          return;
+        }
+
+        while (size > 0) {
+          const uint32_t lineAddress = address & ~(LineSize - 1);
+          const size_t offset = address - lineAddress;
+          const size_t chunkSize = std::min(size, LineSize - offset);
+
+          const Line& line = GetLine(lineAddress);
+          std::memcpy(buffer, line.data.data() + offset, chunkSize);
+
+          address += chunkSize;
+          buffer += chunkSize;
+          size -= chunkSize;
+        }
+      }
+
+      void Invalidate(uint32_t address, size_t size) {
+        for (auto& line : lines) {
+          if (line.valid && line.address < address + size && address < line.address + LineSize) {
+            line.valid = false;
+          }
+        }
+      }
+
+      const Statistics& GetStatistics() const {
+        return statistics;
+      }
+
+    private:
+      struct Line {
+        bool valid = false;
+        uint32_t address = 0;
+        uint32_t lastUse = 0;
+        std::array<uint8_t, LineSize> data;
+      };
+
+      const Line& GetLine(uint32_t lineAddress) {
+        useCounter++;
+
+        Line* victim = &lines[0];
+        for (auto& line : lines) {
+          if (line.valid && line.address == lineAddress) {
+            statistics.hits++;
+            line.lastUse = useCounter;
+            return line;
+          }
+          if (!line.valid || (victim->valid && line.lastUse < victim->lastUse)) {
+            victim = &line;
+          }
+        }
+
+        statistics.misses++;
+        flashDriver.Read(lineAddress, victim->data.data(), LineSize);
+        victim->valid = true;
+        victim->address = lineAddress;
+        victim->lastUse = useCounter;
+        return *victim;
+      }
+
+      Pinetime::Drivers::SpiNorFlash& flashDriver;
+      std::array<Line, NbLines> lines;
+      uint32_t useCounter = 0;
+      Statistics statistics;
+    };
+  }
+}
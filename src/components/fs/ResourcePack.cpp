@@ -0,0 +1,193 @@
+#include "components/fs/ResourcePack.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <algorithm>
+#include <cstring>
+#include "components/fs/FS.h"
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // CRC32 (same as zlib), one nibble at a time to keep the table small
+  constexpr std::array<uint32_t, 16> crcTable {0x00000000,
+                                               0x1DB71064,
+                                               0x3B6E20C8,
+                                               0x26D930AC,
+                                               0x76DC4190,
+                                               0x6B6B51F4,
+                                               0x4DB26158,
+                                               0x5005713C,
+                                               0xEDB88320,
+                                               0xF00F9344,
+                                               0xD6D6A3E8,
+                                               0xCB61B38C,
+                                               0x9B64C2B0,
+                                               0x86D3D2D4,
+                                               0xA00AE278,
+                                               0xBDBDF21C};
+}
+
+ResourcePack::ResourcePack(FS& filesystem) : filesystem {filesystem} {
+}
+
+uint32_t ResourcePack::Hash(const char* path) {
+  uint32_t hash = 2166136261;
+  while (*path != '\0') {
+    hash ^= static_cast<uint8_t>(*path++);
+    hash *= 16777619;
+  }
+  return hash;
+}
+
+uint32_t ResourcePack::Crc32(uint32_t crc, const uint8_t* data, size_t size) {
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    crc = crcTable[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+    crc = crcTable[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+void ResourcePack::Invalidate() {
+  taskENTER_CRITICAL();
+  nbEntries = 0;
+  generation = generation + 1;
+  taskEXIT_CRITICAL();
+}
+
+bool ResourcePack::Load() {
+  taskENTER_CRITICAL();
+  nbEntries = 0;
+  const uint32_t loadedGeneration = generation;
+  taskEXIT_CRITICAL();
+
+  lfs_file_t file;
+  if (filesystem.FileOpen(&file, path, LFS_O_RDONLY) < 0) {
+    return false;
+  }
+
+  Header header;
+  bool valid = filesystem.FileRead(&file, reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+               header.magic == magic && header.version == version && header.nbEntries <= maxEntries;
+  if (valid) {
+    const auto indexSize = header.nbEntries * sizeof(Entry);
+    valid = filesystem.FileRead(&file, reinterpret_cast<uint8_t*>(index.data()), indexSize) == static_cast<int>(indexSize) &&
+            Crc32(0, reinterpret_cast<const uint8_t*>(index.data()), indexSize) == header.indexCrc;
+  }
+  if (!valid) {
+    filesystem.FileClose(&file);
+    return false;
+  }
+
+  // Keep the resources that match their CRC, in the same order
+  uint16_t nbValid = 0;
+  for (uint16_t i = 0; i < header.nbEntries; i++) {
+    const bool inPack = index[i].size <= header.size && index[i].offset <= header.size - index[i].size;
+    if (inPack && VerifyEntry(&file, index[i])) {
+      index[nbValid++] = index[i];
+    }
+  }
+  filesystem.FileClose(&file);
+
+  // The pack has been modified while it was read
+  taskENTER_CRITICAL();
+  const bool invalidated = generation != loadedGeneration;
+  if (!invalidated) {
+    nbEntries = nbValid;
+  }
+  taskEXIT_CRITICAL();
+  return !invalidated && nbValid == header.nbEntries;
+}
+
+bool ResourcePack::VerifyEntry(lfs_file_t* file, const Entry& entry) {
+  if (filesystem.FileSeek(file, entry.offset) < 0) {
+    return false;
+  }
+
+  std::array<uint8_t, 128> buffer;
+  uint32_t crc = 0;
+  uint32_t remaining = entry.size;
+  while (remaining > 0) {
+    const uint32_t chunkSize = std::min<uint32_t>(remaining, buffer.size());
+    if (filesystem.FileRead(file, buffer.data(), chunkSize) != static_cast<int>(chunkSize)) {
+      return false;
+    }
+    crc = Crc32(crc, buffer.data(), chunkSize);
+    remaining -= chunkSize;
+  }
+  return crc == entry.crc;
+}
+
+const ResourcePack::Entry* ResourcePack::Find(const char* path) const {
+  const uint32_t hash = Hash(path);
+  const auto* end = index.begin() + nbEntries;
+  const auto* entry = std::lower_bound(index.begin(), end, hash, [](const Entry& e, uint32_t h) {
+    return e.nameHash < h;
+  });
+  if (entry == end || entry->nameHash != hash) {
+    return nullptr;
+  }
+  return entry;
+}
+
+bool ResourcePack::Exists(const char* path) {
+  if (Find(path) != nullptr) {
+    return true;
+  }
+  lfs_info info;
+  return filesystem.Stat(path, &info) == LFS_ERR_OK && info.type == LFS_TYPE_REG;
+}
+
+int ResourcePack::Open(File* file, const char* path) {
+  const Entry* entry = Find(path);
+  if (entry == nullptr) {
+    file->packed = false;
+    return filesystem.FileOpen(&file->file, path, LFS_O_RDONLY);
+  }
+
+  int res = filesystem.FileOpen(&file->file, ResourcePack::path, LFS_O_RDONLY);
+  if (res < 0) {
+    return res;
+  }
+  res = filesystem.FileSeek(&file->file, entry->offset);
+  if (res < 0) {
+    filesystem.FileClose(&file->file);
+    return res;
+  }
+  file->packed = true;
+  file->offset = entry->offset;
+  file->size = entry->size;
+  file->position = 0;
+  return LFS_ERR_OK;
+}
+
+int ResourcePack::Close(File* file) {
+  return filesystem.FileClose(&file->file);
+}
+
+int ResourcePack::Read(File* file, uint8_t* buffer, uint32_t size) {
+  if (!file->packed) {
+    return filesystem.FileRead(&file->file, buffer, size);
+  }
+
+  // Don't read past the end of the resource, into the next one
+  size = std::min(size, file->size - file->position);
+  int res = filesystem.FileRead(&file->file, buffer, size);
+  if (res > 0) {
+    file->position += res;
+  }
+  return res;
+}
+
+int ResourcePack::Seek(File* file, uint32_t position) {
+  if (!file->packed) {
+    return filesystem.FileSeek(&file->file, position);
+  }
+
+  position = std::min(position, file->size);
+  int res = filesystem.FileSeek(&file->file, file->offset + position);
+  if (res >= 0) {
+    file->position = position;
+  }
+  return res;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <littlefs/lfs.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+
+    /* Resources (fonts, images) stored in a single file of the filesystem, built by tools/resource_pack.py.
+     *
+     * The pack starts with a header and an index sorted by name hash, followed by the data of the resources:
+     *   Header (16 bytes): magic "IRPK", version (uint16), number of entries (uint16), CRC32 of the index, size of the pack
+     *   Entry (16 bytes): FNV-1a hash of the path ("/fonts/teko.bin"), offset in the pack, size, CRC32 of the data
+     * All the values are little endian.
+     *
+     * The index is read once by Load(), so that opening a resource only opens the pack and seeks to its data.
+     * The resources that aren't in the pack are read from their own file, as before the packs were introduced.
+     *
+     * Load(), Exists() and Open() are only called from the DisplayApp task (and once during the initialization of the FS).
+     * Invalidate() can be called from any task, when the pack is about to be modified.
+     */
+    class ResourcePack {
+    public:
+      static constexpr const char* path = "/resources.pak";
+      static constexpr size_t maxEntries = 32;
+
+      struct File {
+        lfs_file_t file;
+        // Data of the resource in the pack, or the whole file if packed is false
+        uint32_t offset;
+        uint32_t size;
+        uint32_t position;
+        bool packed;
+      };
+
+      explicit ResourcePack(FS& filesystem);
+
+      // Reads the index of the pack and checks the data of each resource against its CRC. The resources that don't match are
+      // dropped from the index. Returns false if the pack is missing or invalid, or if any resource is corrupted.
+      bool Load();
+
+      // Empties the index until the next Load(). A Load() in progress doesn't publish the index it read.
+      void Invalidate();
+
+      bool Exists(const char* path);
+
+      // Same return values as FS::FileOpen(), FS::FileRead()...
+      int Open(File* file, const char* path);
+      int Close(File* file);
+      int Read(File* file, uint8_t* buffer, uint32_t size);
+      int Seek(File* file, uint32_t position);
+
+      uint16_t NbEntries() const {
+        return nbEntries;
+      }
+
+      static uint32_t Hash(const char* path);
+      static uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size);
+
+    private:
+      struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t nbEntries;
+        uint32_t indexCrc;
+        uint32_t size;
+      };
+
+      struct Entry {
+        uint32_t nameHash;
+        uint32_t offset;
+        uint32_t size;
+        uint32_t crc;
+      };
+
+      static_assert(sizeof(Header) == 16);
+      static_assert(sizeof(Entry) == 16);
+
+      static constexpr uint32_t magic = 0x4B505249; // "IRPK"
+      static constexpr uint16_t version = 1;
+
+      const Entry* Find(const char* path) const;
+      bool VerifyEntry(lfs_file_t* file, const Entry& entry);
+
+      FS& filesystem;
+      std::array<Entry, maxEntries> index;
+      volatile uint16_t nbEntries = 0;
+      // Incremented by Invalidate()
+      volatile uint32_t generation = 0;
+    };
+  }
+}
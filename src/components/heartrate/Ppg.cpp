@@ -1,17 +1,20 @@
 #include "components/heartrate/Ppg.h"
 #include <nrf_log.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 using namespace Pinetime::Controllers;
 
 namespace {
-  float LinearInterpolation(const float* xValues, const float* yValues, int length, float pointX) {
+  // index must be 0 on the first call and is updated to the position of pointX in xValues, so that a sequence of calls
+  // with increasing pointX values only walks through xValues once.
+  float LinearInterpolation(const float* xValues, const float* yValues, int length, float pointX, int& index) {
     if (pointX > xValues[length - 1]) {
       return yValues[length - 1];
     } else if (pointX <= xValues[0]) {
       return yValues[0];
     }
-    int index = 0;
     while (pointX > xValues[index] && index < length - 1) {
       index++;
     }
@@ -30,11 +33,12 @@ namespace {
     float minBin = 0.0f;
     float maxBin = 0.0f;
     float peakCenter = 0.0f;
-    float prevValue = LinearInterpolation(xVals, yVals, length, start - 0.01f);
-    float currValue = LinearInterpolation(xVals, yVals, length, start);
+    int interpolationIndex = 0;
+    float prevValue = LinearInterpolation(xVals, yVals, length, start - 0.01f, interpolationIndex);
+    float currValue = LinearInterpolation(xVals, yVals, length, start, interpolationIndex);
     float idx = start;
     while (idx < end) {
-      float nextValue = LinearInterpolation(xVals, yVals, length, idx + 0.01f);
+      float nextValue = LinearInterpolation(xVals, yVals, length, idx + 0.01f, interpolationIndex);
       if (currValue < threshold) {
         enabled = true;
       }
@@ -135,6 +139,63 @@ namespace {
     0.15088159f, 0.1882551f,  0.22872687f, 0.27189467f, 0.31732949f, 0.36457977f, 0.41317591f, 0.46263495f,
     0.51246535f, 0.56217185f, 0.61126047f, 0.65924333f, 0.70564355f, 0.75f,       0.79187184f, 0.83084292f,
     0.86652594f, 0.89856625f, 0.92664544f, 0.95048443f, 0.96984631f, 0.98453864f, 0.99441541f, 0.99937846f};
+
+#ifdef PPG_BACKEND_Q15
+  // First quarter of the sine wave in Q15: python -c 'import numpy;print(numpy.round(numpy.sin(numpy.arange(17)*numpy.pi/32)*32767))'
+  // Note: Hardcoded and must be updated if constexpr dataLength is changed.
+  static_assert(Ppg::dataLength == 64);
+  static constexpr int16_t sineQ15[(Ppg::dataLength >> 2) + 1] {
+    0, 3212, 6393, 9512, 12539, 15446, 18204, 20787, 23170, 25329, 27245, 28898, 30273, 31356, 32137, 32609, 32767};
+
+  // Largest value of the input signal once scaled. Leaves 1 bit of headroom for the rounding errors of the butterflies.
+  static constexpr int32_t fftInputScale = 1 << 14;
+
+  int16_t MultiplyQ15(int16_t a, int16_t b) {
+    return static_cast<int16_t>((static_cast<int32_t>(a) * b + (1 << 14)) >> 15);
+  }
+
+  // In place radix-2 decimation in time FFT on Q15 values. Each stage divides the values by 2 to prevent overflows,
+  // so the result is the spectrum divided by dataLength.
+  void FftQ15(std::array<int16_t, Ppg::dataLength>& real, std::array<int16_t, Ppg::dataLength>& imag) {
+    constexpr int length = Ppg::dataLength;
+    constexpr int quarter = length >> 2;
+
+    for (int i = 1, j = 0; i < length; i++) {
+      int bit = length >> 1;
+      for (; (j & bit) != 0; bit >>= 1) {
+        j ^= bit;
+      }
+      j |= bit;
+      if (i < j) {
+        std::swap(real[i], real[j]);
+        std::swap(imag[i], imag[j]);
+      }
+    }
+
+    for (int size = 2; size <= length; size <<= 1) {
+      int half = size >> 1;
+      int step = length / size;
+      for (int k = 0; k < half; k++) {
+        // Twiddle factor exp(-2*pi*i*k/size)
+        int angle = k * step;
+        int16_t twiddleCos = (angle <= quarter) ? sineQ15[quarter - angle] : -sineQ15[angle - quarter];
+        int16_t twiddleSin = (angle <= quarter) ? sineQ15[angle] : sineQ15[(length >> 1) - angle];
+        for (int start = 0; start < length; start += size) {
+          int top = start + k;
+          int bottom = top + half;
+          int32_t tReal = MultiplyQ15(real[bottom], twiddleCos) + MultiplyQ15(imag[bottom], twiddleSin);
+          int32_t tImag = MultiplyQ15(imag[bottom], twiddleCos) - MultiplyQ15(real[bottom], twiddleSin);
+          int32_t topReal = real[top];
+          int32_t topImag = imag[top];
+          real[top] = static_cast<int16_t>((topReal + tReal) >> 1);
+          imag[top] = static_cast<int16_t>((topImag + tImag) >> 1);
+          real[bottom] = static_cast<int16_t>((topReal - tReal) >> 1);
+          imag[bottom] = static_cast<int16_t>((topImag - tImag) >> 1);
+        }
+      }
+    }
+  }
+#endif
 }
 
 Ppg::Ppg() {
@@ -177,6 +238,7 @@ void Ppg::Reset(bool resetDaqBuffer) {
   lastPeakLocation = 0.0f;
   alsThreshold = UINT16_MAX;
   alsValue = 0;
+  signalToNoise = 0.0f;
   resetSpectralAvg = true;
   spectrum.fill(0.0f);
 }
@@ -199,11 +261,7 @@ int Ppg::ProcessHeartRate(bool init) {
       hannIdx++;
     }
   }
-  // Compute in place power spectrum
-  ArduinoFFT<float> FFT = ArduinoFFT<float>(vReal.data(), vImag.data(), dataLength, sampleFreq);
-  FFT.compute(FFTDirection::Forward);
-  FFT.complexToMagnitude();
-  FFT.~ArduinoFFT();
+  ComputeMagnitude();
   SpectrumAverage(vReal.data(), spectrum.data(), spectrum.size(), init);
   peakLocation = 0.0f;
   float threshold = peakDetectionThreshold;
@@ -211,6 +269,7 @@ int Ppg::ProcessHeartRate(bool init) {
   int specLen = spectrum.size();
   float max = SpectrumMax(spectrum, hrROIbegin, hrROIend);
   float signalToNoiseRatio = SignalToNoise(spectrum, hrROIbegin, hrROIend, max);
+  signalToNoise = signalToNoiseRatio;
   if (signalToNoiseRatio > signalToNoiseThreshold && spectrum.at(0) < dcThreshold) {
     threshold *= max;
     // Reuse VImag for interpolation x values passed to PeakSearch
@@ -252,6 +311,42 @@ int Ppg::ProcessHeartRate(bool init) {
   return rtn;
 }
 
+// Replaces vReal with the magnitude of its spectrum
+#ifdef PPG_BACKEND_Q15
+void Ppg::ComputeMagnitude() {
+  float maxValue = 0.0f;
+  for (float value : vReal) {
+    maxValue = std::max(maxValue, std::fabs(value));
+  }
+  if (maxValue == 0.0f) {
+    return;
+  }
+
+  // Block floating point: the whole signal is scaled to the range of Q15, and the spectrum scaled back
+  float inputScale = static_cast<float>(fftInputScale) / maxValue;
+  for (int idx = 0; idx < dataLength; idx++) {
+    fftReal[idx] = static_cast<int16_t>(std::lround(vReal[idx] * inputScale));
+    fftImag[idx] = 0;
+  }
+  FftQ15(fftReal, fftImag);
+
+  float outputScale = static_cast<float>(dataLength) / inputScale;
+  for (int idx = 0; idx < dataLength; idx++) {
+    int32_t re = fftReal[idx];
+    int32_t im = fftImag[idx];
+    vReal[idx] = std::sqrt(static_cast<float>(re * re + im * im)) * outputScale;
+  }
+}
+#else
+void Ppg::ComputeMagnitude() {
+  // Compute in place power spectrum
+  ArduinoFFT<float> FFT = ArduinoFFT<float>(vReal.data(), vImag.data(), dataLength, sampleFreq);
+  FFT.compute(FFTDirection::Forward);
+  FFT.complexToMagnitude();
+  FFT.~ArduinoFFT();
+}
+#endif
+
 void Ppg::SpectrumAverage(const float* data, float* spectrum, int length, bool reset) {
   if (reset) {
     spectralAvgCount = 0;
@@ -3,11 +3,15 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
-// Note: Change internal define 'sqrt_internal sqrt' to
-// 'sqrt_internal sqrtf' to save ~3KB of flash.
-#define sqrt_internal sqrtf
-#define FFT_SPEED_OVER_PRECISION
-#include "libs/arduinoFFT/src/arduinoFFT.h"
+// The spectrum is computed by arduinoFFT on floats, unless PPG_BACKEND_Q15 is defined (cmake -DPPG_BACKEND=Q15),
+// in which case a Q15 fixed-point FFT is used instead.
+#ifndef PPG_BACKEND_Q15
+  // Note: Change internal define 'sqrt_internal sqrt' to
+  // 'sqrt_internal sqrtf' to save ~3KB of flash.
+  #define sqrt_internal sqrtf
+  #define FFT_SPEED_OVER_PRECISION
+  #include "libs/arduinoFFT/src/arduinoFFT.h"
+#endif
 
 namespace Pinetime {
   namespace Controllers {
@@ -17,6 +21,11 @@ namespace Pinetime {
       int8_t Preprocess(uint16_t hrs, uint16_t als);
       int HeartRate();
       void Reset(bool resetDaqBuffer);
+
+      // Signal to noise ratio of the spectrum used by the last heart rate computation
+      float SignalToNoiseRatio() const {
+        return signalToNoise;
+      }
       static constexpr int deltaTms = 100;
       // Daq dataLength: Must be power of 2
       static constexpr uint16_t dataLength = 64;
@@ -58,6 +67,11 @@ namespace Pinetime {
       std::array<float, dataLength> vReal;
       // Stores Imaginary numbers from FFT
       std::array<float, dataLength> vImag;
+#ifdef PPG_BACKEND_Q15
+      // Working buffers of the fixed-point FFT
+      std::array<int16_t, dataLength> fftReal;
+      std::array<int16_t, dataLength> fftImag;
+#endif
       // Stores power spectrum calculated from FFT real and imag values
       std::array<float, (spectrumLength)> spectrum;
       // Stores each new HR value (Hz). Non zero values are averaged for HR output
@@ -70,9 +84,11 @@ namespace Pinetime {
       uint16_t alsValue = 0;
       uint16_t dataIndex = 0;
       float peakLocation;
+      float signalToNoise = 0.0f;
       bool resetSpectralAvg = true;
 
       int ProcessHeartRate(bool init);
+      void ComputeMagnitude();
       float HeartRateAverage(float hr);
       void SpectrumAverage(const float* data, float* spectrum, int length, bool reset);
     };
@@ -35,7 +35,7 @@ namespace {
   }
 }
 
-void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps) {
+void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps, TickType_t timestamp) {
   if (this->nbSteps != nbSteps && service != nullptr) {
     service->OnNewStepCountValue(nbSteps);
   }
@@ -45,7 +45,7 @@ void MotionController::Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps)
   }
 
   lastTime = time;
-  time = xTaskGetTickCount();
+  time = timestamp;
 
   xHistory++;
   xHistory[0] = x;
@@ -112,7 +112,7 @@ bool MotionController::ShouldRaiseWake() const {
 }
 
 bool MotionController::ShouldShakeWake(uint16_t thresh) {
-  /* Currently Polling at 10hz, If this ever goes faster scalar and EMA might need adjusting */
+  /* Currently sampling at 12.5hz, If this ever goes faster scalar and EMA might need adjusting */
   int32_t speed = std::abs(zHistory[0] - zHistory[histSize - 1] + (yHistory[0] - yHistory[histSize - 1]) / 2 +
                            (xHistory[0] - xHistory[histSize - 1]) / 4) *
                   100 / (time - lastTime);
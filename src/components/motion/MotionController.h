@@ -18,7 +18,8 @@ namespace Pinetime {
         BMA425,
       };
 
-      void Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps);
+      // timestamp is the time at which the sample was acquired, samples are read from the sensor by batches
+      void Update(int16_t x, int16_t y, int16_t z, uint32_t nbSteps, TickType_t timestamp);
 
       int16_t X() const {
         return xHistory[0];
@@ -43,11 +43,27 @@ namespace Pinetime {
         Colors ColorBG = Colors::Black;
         PTSGaugeStyle gaugeStyle = PTSGaugeStyle::Full;
         PTSWeather weatherEnable = PTSWeather::Off;
+
+        bool operator==(const PineTimeStyle&) const = default;
       };
 
       struct WatchFaceInfineat {
         bool showSideCover = true;
         int colorIndex = 0;
+
+        bool operator==(const WatchFaceInfineat&) const = default;
+      };
+
+      // The settings that change how the watch faces look
+      struct WatchFaceSettings {
+        Pinetime::Applications::WatchFace watchFace;
+        ClockType clockType;
+        WeatherFormat weatherFormat;
+        uint32_t stepsGoal;
+        PineTimeStyle PTS;
+        WatchFaceInfineat watchFaceInfineat;
+
+        bool operator==(const WatchFaceSettings&) const = default;
       };
 
       Settings(Pinetime::Controllers::FS& fs);
@@ -67,6 +83,15 @@ namespace Pinetime {
         settings.watchFace = face;
       };
 
+      WatchFaceSettings GetWatchFaceSettings() const {
+        return {settings.watchFace,
+                settings.clockType,
+                settings.weatherFormat,
+                settings.stepsGoal,
+                settings.PTS,
+                settings.watchFaceInfineat};
+      };
+
       Pinetime::Applications::WatchFace GetWatchFace() const {
         return settings.watchFace;
       };
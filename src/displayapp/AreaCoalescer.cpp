@@ -0,0 +1,53 @@
+#include "displayapp/AreaCoalescer.h"
+#include <algorithm>
+
+using namespace Pinetime::Components;
+
+AreaCoalescer::AreaCoalescer(uint32_t bufferSizeInPixels) : bufferSizeInPixels {bufferSizeInPixels} {
+}
+
+uint32_t AreaCoalescer::Cost(const lv_area_t& area) const {
+  uint32_t width = lv_area_get_width(&area);
+  uint32_t height = lv_area_get_height(&area);
+
+  // LVGL renders as many full lines of the area as the buffer can hold, and each of them is flushed separately
+  uint32_t linesPerFlush = std::max<uint32_t>(1, bufferSizeInPixels / width);
+  uint32_t nbFlushes = (height + linesPerFlush - 1) / linesPerFlush;
+
+  return nbFlushes * (commandBytesPerFlush + transactionOverheadBytes) + (width * height * bytesPerPixel);
+}
+
+void AreaCoalescer::Coalesce(lv_disp_t* disp) {
+  bool merged;
+  do {
+    merged = false;
+    for (uint16_t i = 0; i < disp->inv_p; i++) {
+      if (disp->inv_area_joined[i] != 0) {
+        continue;
+      }
+      for (uint16_t j = i + 1; j < disp->inv_p; j++) {
+        if (disp->inv_area_joined[j] != 0) {
+          continue;
+        }
+
+        lv_area_t joined;
+        _lv_area_join(&joined, &disp->inv_areas[i], &disp->inv_areas[j]);
+
+        uint32_t separateCost = Cost(disp->inv_areas[i]) + Cost(disp->inv_areas[j]);
+        uint32_t joinedCost = Cost(joined);
+        if (joinedCost < separateCost) {
+          lv_area_copy(&disp->inv_areas[i], &joined);
+          disp->inv_area_joined[j] = 1;
+          currentFrame.areasMerged++;
+          currentFrame.bytesSaved += separateCost - joinedCost;
+          merged = true;
+        }
+      }
+    }
+  } while (merged);
+}
+
+void AreaCoalescer::FrameDone() {
+  lastFrame = currentFrame;
+  currentFrame = {};
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Components {
+    /* Merges the areas invalidated by LVGL before they are rendered and flushed to the display.
+     * Each flush costs a CASET/RASET/RAMWR sequence (and as many SPI transactions) on top of the pixel data,
+     * so two nearby areas are cheaper to send as their bounding box than separately, even if some pixels
+     * are sent twice. Areas are merged only when the estimated number of bytes on the bus decreases.
+     */
+    class AreaCoalescer {
+    public:
+      struct Statistics {
+        uint32_t areasMerged = 0;
+        // Estimated number of bytes (pixels + commands + transaction overhead) not sent on the SPI bus
+        uint32_t bytesSaved = 0;
+      };
+
+      explicit AreaCoalescer(uint32_t bufferSizeInPixels);
+
+      void Coalesce(lv_disp_t* disp);
+      void FrameDone();
+
+      uint32_t Cost(const lv_area_t& area) const;
+
+      const Statistics& LastFrame() const {
+        return lastFrame;
+      }
+
+    private:
+      // CASET + 4 bytes, RASET + 4 bytes, RAMWR
+      static constexpr uint32_t commandBytesPerFlush = 11;
+      // Time spent setting up the 3 SPI transactions of a flush (CS, D/C, interrupts), expressed in bytes at 8MHz
+      static constexpr uint32_t transactionOverheadBytes = 3 * 16;
+      static constexpr uint32_t bytesPerPixel = 2;
+
+      const uint32_t bufferSizeInPixels;
+      Statistics currentFrame;
+      Statistics lastFrame;
+    };
+  }
+}
@@ -100,6 +100,7 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
     filesystem {filesystem},
     spiNorFlash {spiNorFlash},
     lvgl {lcd, filesystem},
+    fontCache {filesystem},
     timer(this, TimerCallback),
     controllers {batteryController,
                  bleController,
@@ -118,7 +119,8 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
                  this,
                  lvgl,
                  nullptr,
-                 nullptr} {
+                 nullptr,
+                 fontCache} {
 }
 
 void DisplayApp::Start(System::BootErrors error) {
@@ -129,6 +131,9 @@ void DisplayApp::Start(System::BootErrors error) {
   lvgl.Init();
   motorController.Init();
 
+  appScreen = lv_scr_act();
+  clockScreen = lv_obj_create(nullptr, nullptr);
+
   if (error == System::BootErrors::TouchController) {
     LoadNewScreen(Apps::Error, DisplayApp::FullRefreshDirections::None);
   } else {
@@ -319,6 +324,8 @@ void DisplayApp::Refresh() {
           while (!lv_task_handler()) {
           };
         }
+        // Load the fonts of the watch face while the display is off, they may have been freed to make room for an app
+        PreloadWatchFaceFonts();
         // Clear any ongoing touch pressed events
         // Without this LVGL gets stuck in the pressed state and will keep refreshing the
         // display activity timer causing the screen to never sleep after timeout
@@ -478,6 +485,10 @@ void DisplayApp::Refresh() {
       case Messages::OnChargingEvent:
         motorController.RunForDuration(15);
         break;
+      case Messages::ReloadResources:
+        // The index is only used from this task, the resources are checked against their CRC here rather than in the BLE task
+        filesystem.VerifyResource();
+        break;
     }
   }
 
@@ -512,7 +523,40 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
   lv_disp_trig_activity(nullptr);
   motorController.StopRinging();
 
-  currentScreen.reset(nullptr);
+  const auto& frameStatistics = lvgl.GetFrameStatistics();
+  if (frameStatistics.nbFrames > 0) {
+    NRF_LOG_INFO("[DisplayApp] App %d : %d frames, avg %d ms, max %d ms, %d px, min free heap %d",
+                 static_cast<int>(currentApp),
+                 frameStatistics.nbFrames,
+                 (frameStatistics.totalFrameTime * 1000 / configTICK_RATE_HZ) / frameStatistics.nbFrames,
+                 frameStatistics.maxFrameTime * 1000 / configTICK_RATE_HZ,
+                 frameStatistics.pixelsFlushed,
+                 frameStatistics.minFreeHeap);
+    NRF_LOG_INFO("[DisplayApp] App %d : %d areas merged, %d bytes saved (%d per frame)",
+                 static_cast<int>(currentApp),
+                 frameStatistics.areasMerged,
+                 frameStatistics.bytesSaved,
+                 frameStatistics.bytesSaved / frameStatistics.nbFrames);
+  }
+  lvgl.ResetFrameStatistics();
+  // Fonts and images are read by this task, the cache is mostly used while loading screens
+  const auto& readCacheStatistics = filesystem.GetReadCacheStatistics();
+  NRF_LOG_INFO("[DisplayApp] FS read cache : %d hits, %d misses, %d bypasses",
+               readCacheStatistics.hits,
+               readCacheStatistics.misses,
+               readCacheStatistics.bypasses);
+
+  if (!SuspendClock(app)) {
+    currentScreen.reset(nullptr);
+  }
+  if (suspendedClock != nullptr && xPortGetFreeHeapSize() < suspendedClockMinFreeHeap) {
+    DestroySuspendedClock();
+  }
+  if (xPortGetFreeHeapSize() < suspendedClockMinFreeHeap) {
+    fontCache.FreeUnused();
+  }
+
+  lv_scr_load(app == Apps::Clock ? clockScreen : appScreen);
   SetFullRefresh(direction);
 
   switch (app) {
@@ -530,18 +574,18 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
                                                                  filesystem,
                                                                  std::move(apps));
     } break;
-    case Apps::Clock: {
-      const auto* watchFace =
-        std::find_if(userWatchFaces.begin(), userWatchFaces.end(), [this](const WatchFaceDescription& watchfaceDescription) {
-          return watchfaceDescription.watchFace == settingsController.GetWatchFace();
-        });
-      if (watchFace != userWatchFaces.end())
-        currentScreen.reset(watchFace->create(controllers));
-      else {
-        currentScreen.reset(userWatchFaces[0].create(controllers));
+    case Apps::Clock:
+      if (suspendedClock != nullptr && suspendedClockSettings == settingsController.GetWatchFaceSettings()) {
+        currentScreen = std::move(suspendedClock);
+        currentScreen->Resume();
+      } else {
+        if (suspendedClock != nullptr) {
+          DestroySuspendedClock();
+        }
+        CreateClock();
       }
       settingsController.SetAppMenu(0);
-    } break;
+      break;
     case Apps::Error:
       currentScreen = std::make_unique<Screens::Error>(bootError);
       break;
@@ -651,6 +695,55 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
     }
   }
   currentApp = app;
+
+  if (suspendedClock != nullptr && xPortGetFreeHeapSize() < suspendedClockMinFreeHeap) {
+    DestroySuspendedClock();
+  }
+}
+
+void DisplayApp::PreloadWatchFaceFonts() {
+  const auto* watchFace =
+    std::find_if(userWatchFaces.begin(), userWatchFaces.end(), [this](const WatchFaceDescription& watchfaceDescription) {
+      return watchfaceDescription.watchFace == settingsController.GetWatchFace();
+    });
+  // Don't take the memory of the app that is displayed
+  if (watchFace != userWatchFaces.end() && xPortGetFreeHeapSize() >= Components::FontCache::budget + suspendedClockMinFreeHeap) {
+    watchFace->preloadFonts(fontCache);
+  }
+}
+
+void DisplayApp::CreateClock() {
+  const auto* watchFace =
+    std::find_if(userWatchFaces.begin(), userWatchFaces.end(), [this](const WatchFaceDescription& watchfaceDescription) {
+      return watchfaceDescription.watchFace == settingsController.GetWatchFace();
+    });
+  if (watchFace != userWatchFaces.end())
+    currentScreen.reset(watchFace->create(controllers));
+  else {
+    currentScreen.reset(userWatchFaces[0].create(controllers));
+  }
+}
+
+bool DisplayApp::SuspendClock(Apps nextApp) {
+  if (currentApp != Apps::Clock || nextApp == Apps::Clock || !currentScreen->CanBeSuspended()) {
+    return false;
+  }
+  if (xPortGetFreeHeapSize() < suspendedClockMinFreeHeap) {
+    return false;
+  }
+  // Its objects stay on clockScreen, which isn't rendered until it's loaded again
+  currentScreen->Suspend();
+  suspendedClockSettings = settingsController.GetWatchFaceSettings();
+  suspendedClock = std::move(currentScreen);
+  return true;
+}
+
+void DisplayApp::DestroySuspendedClock() {
+  // The watch faces clean the active screen when they are destroyed
+  lv_obj_t* activeScreen = lv_scr_act();
+  lv_scr_load(clockScreen);
+  suspendedClock.reset(nullptr);
+  lv_scr_load(activeScreen);
 }
 
 void DisplayApp::PushMessage(Messages msg) {
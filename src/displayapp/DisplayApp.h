@@ -6,6 +6,7 @@
 #include <systemtask/Messages.h>
 #include "displayapp/apps/Apps.h"
 #include "displayapp/LittleVgl.h"
+#include "displayapp/FontCache.h"
 #include "displayapp/TouchEvents.h"
 #include "components/brightness/BrightnessController.h"
 #include "components/motor/MotorController.h"
@@ -80,6 +81,10 @@ namespace Pinetime {
       void Register(Pinetime::Controllers::MusicService* musicService);
       void Register(Pinetime::Controllers::NavigationService* NavigationService);
 
+      QueueHandle_t MessageQueue() const {
+        return msgQueue;
+      }
+
     private:
       Pinetime::Drivers::St7789& lcd;
       const Pinetime::Drivers::Cst816S& touchPanel;
@@ -101,6 +106,7 @@ namespace Pinetime {
 
       Pinetime::Controllers::FirmwareValidator validator;
       Pinetime::Components::LittleVgl lvgl;
+      Pinetime::Components::FontCache fontCache;
       Pinetime::Controllers::Timer timer;
 
       AppControllers controllers;
@@ -114,6 +120,16 @@ namespace Pinetime {
 
       std::unique_ptr<Screens::Screen> currentScreen;
 
+      // The clock is kept alive on its own LVGL screen while the apps opened from it are displayed, so that going back to it
+      // (including when the display goes to sleep) doesn't rebuild the watch face nor reload its fonts from the external flash.
+      std::unique_ptr<Screens::Screen> suspendedClock;
+      // The suspended clock is rebuilt if these settings changed (settings apps, quick settings, BLE...) while it was suspended
+      Controllers::Settings::WatchFaceSettings suspendedClockSettings;
+      lv_obj_t* clockScreen = nullptr;
+      lv_obj_t* appScreen = nullptr;
+      // The suspended clock is destroyed when the free heap goes below this threshold
+      static constexpr size_t suspendedClockMinFreeHeap = 8 * 1024;
+
       Apps currentApp = Apps::None;
       Apps returnToApp = Apps::None;
       FullRefreshDirections returnDirection = FullRefreshDirections::None;
@@ -125,6 +141,10 @@ namespace Pinetime {
       void Refresh();
       void LoadNewScreen(Apps app, DisplayApp::FullRefreshDirections direction);
       void LoadScreen(Apps app, DisplayApp::FullRefreshDirections direction);
+      bool SuspendClock(Apps nextApp);
+      void DestroySuspendedClock();
+      void CreateClock();
+      void PreloadWatchFaceFonts();
       void PushMessageToSystemTask(Pinetime::System::Messages message);
 
       Apps nextApp = Apps::None;
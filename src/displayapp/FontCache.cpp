@@ -0,0 +1,198 @@
+#include "displayapp/FontCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "components/fs/FS.h"
+
+using namespace Pinetime::Components;
+
+namespace {
+  // Memory allocated by lv_font_load() for the font, computed from its descriptor. Measuring the free heap around
+  // lv_font_load() doesn't work: the small allocations come from the LVGL pools, which may or may not need a new slab.
+  size_t LoadedFontSize(const lv_font_t* font) {
+    const auto* dsc = static_cast<const lv_font_fmt_txt_dsc_t*>(font->dsc);
+    size_t size = sizeof(lv_font_t) + sizeof(lv_font_fmt_txt_dsc_t) + dsc->cmap_num * sizeof(lv_font_fmt_txt_cmap_t);
+
+    // The glyphs are numbered through the character maps, glyph 0 is reserved
+    uint32_t nbGlyphs = 1;
+    for (uint16_t i = 0; i < dsc->cmap_num; i++) {
+      const auto& cmap = dsc->cmaps[i];
+      uint32_t nbMappedGlyphs = 0;
+      switch (cmap.type) {
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+          nbMappedGlyphs = cmap.range_length;
+          break;
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL: {
+          const auto* offsets = static_cast<const uint8_t*>(cmap.glyph_id_ofs_list);
+          for (uint16_t j = 0; j < cmap.range_length; j++) {
+            nbMappedGlyphs = std::max<uint32_t>(nbMappedGlyphs, offsets[j] + 1);
+          }
+          size += cmap.range_length;
+          break;
+        }
+        case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+          nbMappedGlyphs = cmap.list_length;
+          size += cmap.list_length * sizeof(uint16_t);
+          break;
+        case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL: {
+          const auto* offsets = static_cast<const uint16_t*>(cmap.glyph_id_ofs_list);
+          for (uint16_t j = 0; j < cmap.list_length; j++) {
+            nbMappedGlyphs = std::max<uint32_t>(nbMappedGlyphs, offsets[j] + 1);
+          }
+          size += cmap.list_length * 2 * sizeof(uint16_t);
+          break;
+        }
+      }
+      if (nbMappedGlyphs > 0) {
+        nbGlyphs = std::max<uint32_t>(nbGlyphs, cmap.glyph_id_start + nbMappedGlyphs);
+      }
+    }
+
+    // The bitmaps of the glyphs are stored one after the other
+    size += nbGlyphs * sizeof(lv_font_fmt_txt_glyph_dsc_t);
+    uint32_t bitmapSize = 0;
+    for (uint32_t i = 0; i < nbGlyphs; i++) {
+      const auto& glyph = dsc->glyph_dsc[i];
+      bitmapSize = std::max<uint32_t>(bitmapSize, glyph.bitmap_index + (glyph.box_w * glyph.box_h * dsc->bpp + 7) / 8);
+    }
+    size += bitmapSize;
+
+    if (dsc->kern_dsc != nullptr) {
+      if (dsc->kern_classes == 0) {
+        const auto* kern = static_cast<const lv_font_fmt_txt_kern_pair_t*>(dsc->kern_dsc);
+        const size_t glyphIdSize = (kern->glyph_ids_size == 0) ? sizeof(uint8_t) : sizeof(uint16_t);
+        size += sizeof(*kern) + kern->pair_cnt * (2 * glyphIdSize + sizeof(int8_t));
+      } else {
+        const auto* kern = static_cast<const lv_font_fmt_txt_kern_classes_t*>(dsc->kern_dsc);
+        size += sizeof(*kern) + kern->left_class_cnt * kern->right_class_cnt + 2 * nbGlyphs;
+      }
+    }
+    return size;
+  }
+}
+
+FontCache::FontCache(Pinetime::Controllers::FS& filesystem) : filesystem {filesystem} {
+}
+
+lv_font_t* FontCache::Acquire(const char* path) {
+  Entry* entry = Find(path);
+  if (entry == nullptr) {
+    entry = Load(path);
+  }
+  if (entry == nullptr) {
+    return nullptr;
+  }
+  entry->references++;
+  entry->lastUse = ++useCounter;
+  EnforceBudget();
+  return entry->font;
+}
+
+void FontCache::Release(lv_font_t* font) {
+  for (auto& entry : entries) {
+    if (entry.font == font && entry.references > 0) {
+      entry.references--;
+      entry.lastUse = ++useCounter;
+      EnforceBudget();
+      return;
+    }
+  }
+}
+
+void FontCache::Preload(const char* path) {
+  Entry* entry = Find(path);
+  if (entry == nullptr) {
+    entry = Load(path);
+  }
+  if (entry == nullptr) {
+    return;
+  }
+  entry->lastUse = ++useCounter;
+  EnforceBudget();
+}
+
+void FontCache::FreeUnused() {
+  for (auto& entry : entries) {
+    if (entry.font != nullptr && entry.references == 0) {
+      Free(entry);
+    }
+  }
+}
+
+FontCache::Entry* FontCache::Find(const char* path) {
+  for (auto& entry : entries) {
+    if (entry.font != nullptr && std::strcmp(entry.path.data(), path) == 0) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+FontCache::Entry* FontCache::Load(const char* path) {
+  if (std::strlen(path) > maxPathLength) {
+    return nullptr;
+  }
+
+  // LVGL crashes when loading a font that doesn't exist
+  if (!filesystem.GetResourcePack().Exists(path)) {
+    return nullptr;
+  }
+
+  // Use a free entry, or the least recently used font that isn't used anymore
+  Entry* entry = nullptr;
+  Entry* leastRecentlyUsed = nullptr;
+  for (auto& candidate : entries) {
+    if (candidate.font == nullptr) {
+      entry = &candidate;
+      break;
+    }
+    if (candidate.references == 0 && (leastRecentlyUsed == nullptr || candidate.lastUse < leastRecentlyUsed->lastUse)) {
+      leastRecentlyUsed = &candidate;
+    }
+  }
+  if (entry == nullptr) {
+    if (leastRecentlyUsed == nullptr) {
+      return nullptr;
+    }
+    Free(*leastRecentlyUsed);
+    entry = leastRecentlyUsed;
+  }
+
+  std::array<char, maxPathLength + 3> lvglPath;
+  snprintf(lvglPath.data(), lvglPath.size(), "F:%s", path);
+  // The whole font (glyph descriptions and bitmaps) is allocated by lv_font_load()
+  lv_font_t* font = lv_font_load(lvglPath.data());
+  if (font == nullptr) {
+    return nullptr;
+  }
+
+  std::strcpy(entry->path.data(), path);
+  entry->font = font;
+  entry->size = LoadedFontSize(font);
+  entry->references = 0;
+  size += entry->size;
+  return entry;
+}
+
+void FontCache::Free(Entry& entry) {
+  lv_font_free(entry.font);
+  entry.font = nullptr;
+  size -= entry.size;
+}
+
+void FontCache::EnforceBudget() {
+  while (size > budget) {
+    Entry* leastRecentlyUsed = nullptr;
+    for (auto& entry : entries) {
+      if (entry.font != nullptr && entry.references == 0 &&
+          (leastRecentlyUsed == nullptr || entry.lastUse < leastRecentlyUsed->lastUse)) {
+        leastRecentlyUsed = &entry;
+      }
+    }
+    if (leastRecentlyUsed == nullptr) {
+      return;
+    }
+    Free(*leastRecentlyUsed);
+  }
+}
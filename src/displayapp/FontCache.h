@@ -0,0 +1,63 @@
+#pragma once
+
+#include <lvgl/lvgl.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+  }
+
+  namespace Components {
+    /* Fonts loaded from the filesystem with lv_font_load(), shared by the screens that use them.
+     * Fonts that aren't used anymore stay loaded so that the next screen using them doesn't parse them again, as long as
+     * the cached fonts fit in the RAM budget: the least recently used ones are freed first. Fonts in use are never freed.
+     * Only used from the DisplayApp task.
+     */
+    class FontCache {
+    public:
+      static constexpr size_t maxFonts = 6;
+      static constexpr size_t maxPathLength = 31;
+      static constexpr size_t budget = 16 * 1024;
+
+      explicit FontCache(Pinetime::Controllers::FS& filesystem);
+
+      // path is the path of the font in the filesystem ("/fonts/teko.bin").
+      // Returns nullptr if the font doesn't exist or can't be loaded, otherwise it must be released with Release().
+      lv_font_t* Acquire(const char* path);
+      void Release(lv_font_t* font);
+
+      // Loads the font if needed, without using it, so that the next call to Acquire() is free
+      void Preload(const char* path);
+
+      // Frees the fonts that aren't used
+      void FreeUnused();
+
+      size_t Size() const {
+        return size;
+      }
+
+    private:
+      struct Entry {
+        std::array<char, maxPathLength + 1> path;
+        lv_font_t* font = nullptr;
+        // Memory allocated for the font, computed from its glyphs, character maps and kerning
+        size_t size;
+        uint8_t references;
+        uint32_t lastUse;
+      };
+
+      Entry* Find(const char* path);
+      Entry* Load(const char* path);
+      void Free(Entry& entry);
+      void EnforceBudget();
+
+      Pinetime::Controllers::FS& filesystem;
+      std::array<Entry, maxFonts> entries {};
+      size_t size = 0;
+      uint32_t useCounter = 0;
+    };
+  }
+}
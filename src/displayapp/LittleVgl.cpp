@@ -1,6 +1,7 @@
 #include "displayapp/LittleVgl.h"
 #include "displayapp/InfiniTimeTheme.h"
 
+#include <algorithm>
 #include <FreeRTOS.h>
 #include <task.h>
 #include "drivers/St7789.h"
@@ -15,12 +16,15 @@ namespace {
     lv_theme_set_act(theme);
   }
 
+  // The files are read from the resource pack when it contains them
+  using ResourceFile = Pinetime::Controllers::ResourcePack::File;
+
   lv_fs_res_t lvglOpen(lv_fs_drv_t* drv, void* file_p, const char* path, lv_fs_mode_t /*mode*/) {
-    lfs_file_t* file = static_cast<lfs_file_t*>(file_p);
+    auto* file = static_cast<ResourceFile*>(file_p);
     Pinetime::Controllers::FS* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
-    int res = filesys->FileOpen(file, path, LFS_O_RDONLY);
+    int res = filesys->GetResourcePack().Open(file, path);
     if (res == 0) {
-      if (file->type == 0) {
+      if (file->file.type == 0) {
         return LV_FS_RES_FS_ERR;
       } else {
         return LV_FS_RES_OK;
@@ -31,24 +35,24 @@ namespace {
 
   lv_fs_res_t lvglClose(lv_fs_drv_t* drv, void* file_p) {
     Pinetime::Controllers::FS* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
-    lfs_file_t* file = static_cast<lfs_file_t*>(file_p);
-    filesys->FileClose(file);
+    auto* file = static_cast<ResourceFile*>(file_p);
+    filesys->GetResourcePack().Close(file);
 
     return LV_FS_RES_OK;
   }
 
   lv_fs_res_t lvglRead(lv_fs_drv_t* drv, void* file_p, void* buf, uint32_t btr, uint32_t* br) {
     Pinetime::Controllers::FS* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
-    lfs_file_t* file = static_cast<lfs_file_t*>(file_p);
-    filesys->FileRead(file, static_cast<uint8_t*>(buf), btr);
+    auto* file = static_cast<ResourceFile*>(file_p);
+    filesys->GetResourcePack().Read(file, static_cast<uint8_t*>(buf), btr);
     *br = btr;
     return LV_FS_RES_OK;
   }
 
   lv_fs_res_t lvglSeek(lv_fs_drv_t* drv, void* file_p, uint32_t pos) {
     Pinetime::Controllers::FS* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
-    lfs_file_t* file = static_cast<lfs_file_t*>(file_p);
-    filesys->FileSeek(file, pos);
+    auto* file = static_cast<ResourceFile*>(file_p);
+    filesys->GetResourcePack().Seek(file, pos);
     return LV_FS_RES_OK;
   }
 }
@@ -58,6 +62,17 @@ static void disp_flush(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_
   lvgl->FlushDisplay(area, color_p);
 }
 
+static void wait_flush(lv_disp_drv_t* disp_drv) {
+  auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+  lvgl->WaitFlushComplete();
+}
+
+static void refresh_task(lv_task_t* task) {
+  auto* disp = static_cast<lv_disp_t*>(task->user_data);
+  auto* lvgl = static_cast<LittleVgl*>(disp->driver.user_data);
+  lvgl->RefreshDisplay(task);
+}
+
 static void rounder(lv_disp_drv_t* disp_drv, lv_area_t* area) {
   auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
   if (lvgl->GetFullRefresh()) {
@@ -82,9 +97,14 @@ void LittleVgl::Init() {
   InitDisplay();
   InitTouchpad();
   InitFileSystem();
+  ResetFrameStatistics();
 }
 
 void LittleVgl::InitDisplay() {
+  if (flushComplete == nullptr) {
+    flushComplete = xSemaphoreCreateBinary();
+  }
+
   lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * 4); /*Initialize the display buffer*/
   lv_disp_drv_init(&disp_drv);                                       /*Basic initialization*/
 
@@ -100,9 +120,42 @@ void LittleVgl::InitDisplay() {
   disp_drv.buffer = &disp_buf_2;
   disp_drv.user_data = this;
   disp_drv.rounder_cb = rounder;
+  /*Flushes are asynchronous: render into one buffer while the other one is sent to the display*/
+  disp_drv.wait_cb = wait_flush;
 
   /*Finally register the driver*/
-  lv_disp_drv_register(&disp_drv);
+  lv_disp_t* disp = lv_disp_drv_register(&disp_drv);
+
+  /*Merge the invalidated areas right before each refresh*/
+  lv_task_set_cb(disp->refr_task, refresh_task);
+}
+
+void LittleVgl::RefreshDisplay(lv_task_t* task) {
+  auto* disp = static_cast<lv_disp_t*>(task->user_data);
+  bool pendingAreas = disp->inv_p > 0;
+  if (pendingAreas) {
+    areaCoalescer.Coalesce(disp);
+  }
+
+  TickType_t frameStart = xTaskGetTickCount();
+  _lv_disp_refr_task(task);
+
+  if (pendingAreas) {
+    areaCoalescer.FrameDone();
+    frameStatistics.areasMerged += areaCoalescer.LastFrame().areasMerged;
+    frameStatistics.bytesSaved += areaCoalescer.LastFrame().bytesSaved;
+
+    TickType_t frameTime = xTaskGetTickCount() - frameStart;
+    frameStatistics.nbFrames++;
+    frameStatistics.totalFrameTime += frameTime;
+    frameStatistics.maxFrameTime = std::max(frameStatistics.maxFrameTime, frameTime);
+    frameStatistics.minFreeHeap = std::min(frameStatistics.minFreeHeap, xPortGetFreeHeapSize());
+  }
+}
+
+void LittleVgl::ResetFrameStatistics() {
+  frameStatistics = {};
+  frameStatistics.minFreeHeap = xPortGetFreeHeapSize();
 }
 
 void LittleVgl::InitTouchpad() {
@@ -119,7 +172,7 @@ void LittleVgl::InitFileSystem() {
   lv_fs_drv_t fs_drv;
   lv_fs_drv_init(&fs_drv);
 
-  fs_drv.file_size = sizeof(lfs_file_t);
+  fs_drv.file_size = sizeof(Pinetime::Controllers::ResourcePack::File);
   fs_drv.letter = 'F';
   fs_drv.open_cb = lvglOpen;
   fs_drv.close_cb = lvglClose;
@@ -163,6 +216,7 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
 
   width = (area->x2 - area->x1) + 1;
   height = (area->y2 - area->y1) + 1;
+  frameStatistics.pixelsFlushed += width * height;
 
   if (scrollDirection == LittleVgl::FullRefreshDirections::Down) {
 
@@ -210,6 +264,9 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
     }
   }
 
+  // DrawBuffer() returns as soon as the pixel transfer is started.
+  // LVGL is informed that the buffer can be reused from the SPI interrupt (OnFlushComplete()),
+  // and meanwhile renders the next area into the other buffer.
   if (y2 < y1) {
     height = totalNbLines - y1;
 
@@ -219,15 +276,34 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
 
     uint16_t pixOffset = width * height;
     height = y2 + 1;
-    lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), width * height * 2);
+    lcd.DrawBuffer(area->x1,
+                   0,
+                   width,
+                   height,
+                   reinterpret_cast<const uint8_t*>(color_p + pixOffset),
+                   width * height * 2,
+                   OnFlushComplete,
+                   this);
 
   } else {
-    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2, OnFlushComplete, this);
   }
+}
 
+void LittleVgl::OnFlushComplete(void* instance) {
+  auto* lvgl = static_cast<LittleVgl*>(instance);
   // IMPORTANT!!!
   // Inform the graphics library that you are ready with the flushing
-  lv_disp_flush_ready(&disp_drv);
+  lv_disp_flush_ready(&lvgl->disp_drv);
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(lvgl->flushComplete, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void LittleVgl::WaitFlushComplete() {
+  // The semaphore may still be given from an earlier flush: LVGL checks its flushing flag again after each call
+  xSemaphoreTake(flushComplete, pdMS_TO_TICKS(10));
 }
 
 void LittleVgl::SetNewTouchPoint(int16_t x, int16_t y, bool contact) {
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include <lvgl/lvgl.h>
 #include <components/fs/FS.h>
+#include "displayapp/AreaCoalescer.h"
 
 namespace Pinetime {
   namespace Drivers {
@@ -12,6 +15,21 @@ namespace Pinetime {
     class LittleVgl {
     public:
       enum class FullRefreshDirections { None, Up, Down, Left, Right, LeftAnim, RightAnim };
+
+      // Render cost of the frames refreshed since the last call to ResetFrameStatistics()
+      struct FrameStatistics {
+        uint32_t nbFrames = 0;
+        // Time spent rendering and flushing, in ticks
+        TickType_t totalFrameTime = 0;
+        TickType_t maxFrameTime = 0;
+        uint32_t pixelsFlushed = 0;
+        // Areas merged by the AreaCoalescer, and the estimated number of bytes it saved on the SPI bus
+        uint32_t areasMerged = 0;
+        uint32_t bytesSaved = 0;
+        // Lowest free heap size (LVGL allocates from the FreeRTOS heap) sampled after each frame
+        size_t minFreeHeap = 0;
+      };
+
       LittleVgl(Pinetime::Drivers::St7789& lcd, Pinetime::Controllers::FS& filesystem);
 
       LittleVgl(const LittleVgl&) = delete;
@@ -22,12 +40,20 @@ namespace Pinetime {
       void Init();
 
       void FlushDisplay(const lv_area_t* area, lv_color_t* color_p);
+      void WaitFlushComplete();
+      void RefreshDisplay(lv_task_t* task);
       bool GetTouchPadInfo(lv_indev_data_t* ptr);
       void SetFullRefresh(FullRefreshDirections direction);
       void SetNewTouchPoint(int16_t x, int16_t y, bool contact);
       void CancelTap();
       void ClearTouchState();
 
+      const FrameStatistics& GetFrameStatistics() const {
+        return frameStatistics;
+      }
+
+      void ResetFrameStatistics();
+
       bool GetFullRefresh() {
         bool returnValue = fullRefresh;
         if (fullRefresh) {
@@ -41,6 +67,8 @@ namespace Pinetime {
       void InitTouchpad();
       void InitFileSystem();
 
+      static void OnFlushComplete(void* instance);
+
       Pinetime::Drivers::St7789& lcd;
       Pinetime::Controllers::FS& filesystem;
 
@@ -49,6 +77,12 @@ namespace Pinetime {
       lv_color_t buf2_2[LV_HOR_RES_MAX * 4];
 
       lv_disp_drv_t disp_drv;
+      AreaCoalescer areaCoalescer {LV_HOR_RES_MAX * 4};
+      FrameStatistics frameStatistics;
+
+      // Given from the SPI interrupt each time a flush has been fully transferred to the display,
+      // so that LVGL can wait for the other buffer to be released without spinning.
+      SemaphoreHandle_t flushComplete = nullptr;
 
       bool fullRefresh = false;
       static constexpr uint8_t nbWriteLines = 4;
@@ -0,0 +1,182 @@
+#include "displayapp/LvglPool.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <algorithm>
+#include <array>
+
+extern "C" size_t xPortGetLargestFreeBlockSize();
+extern "C" void* pvPortMallocFrom(size_t xWantedSize, void* pvCallSite);
+extern "C" void vPortFreeFrom(void* pv, void* pvCallSite);
+
+namespace {
+  struct Block {
+    Block* next;
+  };
+
+  struct Slab {
+    Slab* next;
+    Block* freeBlocks;
+    uint16_t nbUsed;
+  };
+
+  struct SizeClass {
+    uint16_t blockSize;
+    uint16_t blocksPerSlab;
+    Slab* slabs = nullptr;
+    uint16_t nbSlabs = 0;
+    uint16_t blocksInUse = 0;
+    uint16_t peakBlocksInUse = 0;
+  };
+
+  // The blocks follow the header, aligned like the allocations of the FreeRTOS heap
+  constexpr size_t slabHeaderSize = (sizeof(Slab) + portBYTE_ALIGNMENT_MASK) & ~static_cast<size_t>(portBYTE_ALIGNMENT_MASK);
+
+  // LVGL adds a 4 bytes header to each allocation. Objects (in their linked list node), styles, style lists and the
+  // extended data of the widgets fall in these classes.
+  std::array<SizeClass, LVGL_POOL_NB_CLASSES> sizeClasses {{{16, 16}, {32, 16}, {64, 12}, {96, 8}}};
+
+  uint32_t heapAllocations = 0;
+  uint32_t failedAllocations = 0;
+
+  // Range of the addresses of all the slabs ever allocated, so that freeing an allocation of the heap doesn't walk the slabs
+  uintptr_t slabsStart = UINTPTR_MAX;
+  uintptr_t slabsEnd = 0;
+
+  uint8_t* SlabBlocks(Slab* slab) {
+    return reinterpret_cast<uint8_t*>(slab) + slabHeaderSize;
+  }
+
+  Slab* CreateSlab(const SizeClass& sizeClass) {
+    // Failing here isn't an allocation failure, the allocation falls back to the heap: don't call pvPortMalloc() if it would
+    // fail, so that it doesn't report it to vApplicationMallocFailedHook()
+    const size_t slabSize = slabHeaderSize + sizeClass.blockSize * sizeClass.blocksPerSlab;
+    if (xPortGetLargestFreeBlockSize() < slabSize) {
+      return nullptr;
+    }
+    auto* slab = static_cast<Slab*>(pvPortMalloc(slabSize));
+    if (slab == nullptr) {
+      return nullptr;
+    }
+    slabsStart = std::min(slabsStart, reinterpret_cast<uintptr_t>(slab));
+    slabsEnd = std::max(slabsEnd, reinterpret_cast<uintptr_t>(slab) + slabSize);
+    slab->nbUsed = 0;
+    slab->freeBlocks = nullptr;
+    uint8_t* blocks = SlabBlocks(slab);
+    for (int i = sizeClass.blocksPerSlab - 1; i >= 0; i--) {
+      auto* block = reinterpret_cast<Block*>(blocks + i * sizeClass.blockSize);
+      block->next = slab->freeBlocks;
+      slab->freeBlocks = block;
+    }
+    return slab;
+  }
+
+  void* AllocateBlock(SizeClass& sizeClass) {
+    Slab* slab = sizeClass.slabs;
+    while (slab != nullptr && slab->freeBlocks == nullptr) {
+      slab = slab->next;
+    }
+    if (slab == nullptr) {
+      slab = CreateSlab(sizeClass);
+      if (slab == nullptr) {
+        return nullptr;
+      }
+      slab->next = sizeClass.slabs;
+      sizeClass.slabs = slab;
+      sizeClass.nbSlabs++;
+    }
+
+    Block* block = slab->freeBlocks;
+    slab->freeBlocks = block->next;
+    slab->nbUsed++;
+    sizeClass.blocksInUse++;
+    if (sizeClass.blocksInUse > sizeClass.peakBlocksInUse) {
+      sizeClass.peakBlocksInUse = sizeClass.blocksInUse;
+    }
+    return block;
+  }
+
+  bool FreeBlock(void* ptr) {
+    if (reinterpret_cast<uintptr_t>(ptr) < slabsStart || reinterpret_cast<uintptr_t>(ptr) >= slabsEnd) {
+      return false;
+    }
+    auto* address = static_cast<uint8_t*>(ptr);
+    for (auto& sizeClass : sizeClasses) {
+      Slab* previous = nullptr;
+      for (Slab* slab = sizeClass.slabs; slab != nullptr; previous = slab, slab = slab->next) {
+        uint8_t* blocks = SlabBlocks(slab);
+        if (address < blocks || address >= blocks + sizeClass.blockSize * sizeClass.blocksPerSlab) {
+          continue;
+        }
+
+        auto* block = static_cast<Block*>(ptr);
+        block->next = slab->freeBlocks;
+        slab->freeBlocks = block;
+        slab->nbUsed--;
+        sizeClass.blocksInUse--;
+
+        // The last slab of a class is kept so that alternating allocations and frees don't hit the heap each time
+        if (slab->nbUsed == 0 && sizeClass.nbSlabs > 1) {
+          if (previous == nullptr) {
+            sizeClass.slabs = slab->next;
+          } else {
+            previous->next = slab->next;
+          }
+          sizeClass.nbSlabs--;
+          vPortFree(slab);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
+void* LvglPoolAlloc(size_t size) {
+  void* ptr = nullptr;
+  vTaskSuspendAll();
+  for (auto& sizeClass : sizeClasses) {
+    if (size <= sizeClass.blockSize) {
+      ptr = AllocateBlock(sizeClass);
+      break;
+    }
+  }
+  if (ptr == nullptr) {
+    // Record the caller of LvglPoolAlloc() in the heap trace (HEAP_TRACE)
+    ptr = pvPortMallocFrom(size, __builtin_return_address(0));
+    heapAllocations++;
+  }
+  if (ptr == nullptr) {
+    failedAllocations++;
+  }
+  xTaskResumeAll();
+  return ptr;
+}
+
+void LvglPoolFree(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  vTaskSuspendAll();
+  if (!FreeBlock(ptr)) {
+    vPortFreeFrom(ptr, __builtin_return_address(0));
+  }
+  xTaskResumeAll();
+}
+
+void LvglPoolGetStatistics(LvglPoolStatistics* statistics) {
+  vTaskSuspendAll();
+  for (size_t i = 0; i < sizeClasses.size(); i++) {
+    const auto& sizeClass = sizeClasses[i];
+    auto& classStatistics = statistics->classes[i];
+    classStatistics.blockSize = sizeClass.blockSize;
+    classStatistics.nbSlabs = sizeClass.nbSlabs;
+    classStatistics.blocksInUse = sizeClass.blocksInUse;
+    classStatistics.blocksCapacity = sizeClass.nbSlabs * sizeClass.blocksPerSlab;
+    classStatistics.peakBlocksInUse = sizeClass.peakBlocksInUse;
+  }
+  statistics->heapAllocations = heapAllocations;
+  statistics->failedAllocations = failedAllocations;
+  statistics->heapFreeSize = xPortGetFreeHeapSize();
+  statistics->heapLargestFreeBlock = xPortGetLargestFreeBlockSize();
+  xTaskResumeAll();
+}
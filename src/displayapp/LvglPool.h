@@ -0,0 +1,41 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Size-class pools for the small and short-lived allocations of LVGL (objects, styles, linked list nodes...).
+// Each class is made of slabs of fixed-size blocks allocated from the FreeRTOS heap, so that creating and deleting
+// screens doesn't fragment it. Larger allocations are forwarded to the FreeRTOS heap.
+// Included by lv_conf.h, this header must stay valid C.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LVGL_POOL_NB_CLASSES 4
+
+typedef struct {
+  uint16_t blockSize;
+  uint16_t nbSlabs;
+  uint16_t blocksInUse;
+  // Blocks in the allocated slabs (in use or free)
+  uint16_t blocksCapacity;
+  uint16_t peakBlocksInUse;
+} LvglPoolClassStatistics;
+
+typedef struct {
+  LvglPoolClassStatistics classes[LVGL_POOL_NB_CLASSES];
+  // Allocations forwarded to the FreeRTOS heap (too large for the pools, or no memory left for a new slab)
+  uint32_t heapAllocations;
+  uint32_t failedAllocations;
+  // Fragmentation of the FreeRTOS heap: the largest allocation that could succeed, compared to the free size
+  size_t heapFreeSize;
+  size_t heapLargestFreeBlock;
+} LvglPoolStatistics;
+
+void* LvglPoolAlloc(size_t size);
+void LvglPoolFree(void* ptr);
+void LvglPoolGetStatistics(LvglPoolStatistics* statistics);
+
+#ifdef __cplusplus
+}
+#endif
@@ -32,6 +32,7 @@ namespace Pinetime {
       const char* name;
       Screens::Screen* (*create)(AppControllers& controllers);
       bool (*isAvailable)(Controllers::FS& fileSystem);
+      void (*preloadFonts)(Components::FontCache& fontCache);
     };
 
     template <Apps t>
@@ -39,9 +40,21 @@ namespace Pinetime {
       return {AppTraits<t>::app, AppTraits<t>::icon, &AppTraits<t>::Create};
     }
 
+    // Watch faces using fonts from the filesystem declare them with a PreloadFonts() function in their traits
+    template <WatchFace t>
+    void PreloadWatchFaceFonts(Components::FontCache& fontCache) {
+      if constexpr (requires { WatchFaceTraits<t>::PreloadFonts(fontCache); }) {
+        WatchFaceTraits<t>::PreloadFonts(fontCache);
+      }
+    }
+
     template <WatchFace t>
     consteval WatchFaceDescription CreateWatchFaceDescription() {
-      return {WatchFaceTraits<t>::watchFace, WatchFaceTraits<t>::name, &WatchFaceTraits<t>::Create, &WatchFaceTraits<t>::IsAvailable};
+      return {WatchFaceTraits<t>::watchFace,
+              WatchFaceTraits<t>::name,
+              &WatchFaceTraits<t>::Create,
+              &WatchFaceTraits<t>::IsAvailable,
+              &PreloadWatchFaceFonts<t>};
     }
 
     template <template <Apps...> typename T, Apps... ts>
@@ -50,6 +50,10 @@ void FirmwareUpdate::Refresh() {
       if (state != States::Running) {
         state = States::Running;
       }
+      // The image is received once the flash has been erased
+      if (transferStartTime == 0 && bleController.FirmwareUpdateCurrentBytes() > 0) {
+        transferStartTime = xTaskGetTickCount();
+      }
       DisplayProgression();
       break;
     case Pinetime::Controllers::Ble::FirmwareUpdateStates::Validated:
@@ -75,7 +79,17 @@ void FirmwareUpdate::DisplayProgression() const {
   const uint32_t total = bleController.FirmwareUpdateTotalBytes();
   const int16_t permille = current / (total / 1000);
 
-  lv_label_set_text_fmt(percentLabel, "%d %%", permille / 10);
+  uint32_t bytesPerSecond = 0;
+  const TickType_t elapsed = xTaskGetTickCount() - transferStartTime;
+  if (transferStartTime != 0 && elapsed > 0) {
+    bytesPerSecond = (static_cast<uint64_t>(current) * configTICK_RATE_HZ) / elapsed;
+  }
+
+  lv_label_set_text_fmt(percentLabel,
+                        "%d %%\n%lu.%lu kB/s",
+                        permille / 10,
+                        bytesPerSecond / 1000,
+                        (bytesPerSecond % 1000) / 100);
 
   lv_bar_set_value(bar1, permille, LV_ANIM_OFF);
 }
@@ -38,6 +38,7 @@ namespace Pinetime {
 
         lv_task_t* taskRefresh;
         TickType_t startTime;
+        TickType_t transferStartTime = 0;
       };
     }
   }
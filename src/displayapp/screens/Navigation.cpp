@@ -269,17 +269,6 @@ void Navigation::Refresh() {
 }
 
 bool Navigation::IsAvailable(Pinetime::Controllers::FS& filesystem) {
-  lfs_file file = {};
-
-  if (filesystem.FileOpen(&file, "/images/navigation0.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-  filesystem.FileClose(&file);
-
-  if (filesystem.FileOpen(&file, "/images/navigation1.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-  filesystem.FileClose(&file);
-
-  return true;
+  auto& resources = filesystem.GetResourcePack();
+  return resources.Exists("/images/navigation0.bin") && resources.Exists("/images/navigation1.bin");
 }
@@ -2,5 +2,8 @@
 using namespace Pinetime::Applications::Screens;
 
 void Screen::RefreshTaskCallback(lv_task_t* task) {
-  static_cast<Screen*>(task->user_data)->Refresh();
+  auto* screen = static_cast<Screen*>(task->user_data);
+  if (!screen->suspended) {
+    screen->Refresh();
+  }
 }
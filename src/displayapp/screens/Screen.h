@@ -14,6 +14,8 @@ namespace Pinetime {
         virtual void Refresh() {
         }
 
+        bool suspended = false;
+
       public:
         explicit Screen() = default;
 
@@ -40,6 +42,22 @@ namespace Pinetime {
           return false;
         }
 
+        /** @return true if the screen can be kept alive on an inactive LVGL screen while another app is displayed */
+        virtual bool CanBeSuspended() const {
+          return false;
+        }
+
+        // Refresh() isn't called by the refresh task while the screen is suspended.
+        // Resume() catches up with what changed in the meantime, once the screen is active again.
+        void Suspend() {
+          suspended = true;
+        }
+
+        void Resume() {
+          suspended = false;
+          Refresh();
+        }
+
       protected:
         bool running = true;
       };
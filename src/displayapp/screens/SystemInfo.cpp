@@ -4,6 +4,7 @@
 #include "displayapp/screens/SystemInfo.h"
 #include <lvgl/lvgl.h>
 #include "displayapp/DisplayApp.h"
+#include "displayapp/LvglPool.h"
 #include "displayapp/screens/Label.h"
 #include "Version.h"
 #include "BootloaderVersion.h"
@@ -181,8 +182,14 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
 extern int mallocFailedCount;
 extern int stackOverflowCount;
 std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
-  lv_mem_monitor_t mon;
-  lv_mem_monitor(&mon);
+  LvglPoolStatistics poolStatistics;
+  LvglPoolGetStatistics(&poolStatistics);
+  uint32_t poolBlocksInUse = 0;
+  uint32_t poolBlocksCapacity = 0;
+  for (const auto& poolClass : poolStatistics.classes) {
+    poolBlocksInUse += poolClass.blocksInUse;
+    poolBlocksCapacity += poolClass.blocksCapacity;
+  }
 
   lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_recolor(label, true);
@@ -193,10 +200,11 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         " %02x:%02x:%02x:%02x:%02x:%02x\n"
                         "\n"
                         "#808080 SPI Flash# %02x-%02x-%02x\n"
-                        "\n"
                         "#808080 Memory heap#\n"
                         " #808080 Free# %d/%d\n"
                         " #808080 Min free# %d\n"
+                        " #808080 Largest# %d\n"
+                        " #808080 LVGL pool# %d/%d\n"
                         " #808080 Alloc err# %d\n"
                         " #808080 Ovrfl err# %d\n",
                         bleAddr[5],
@@ -211,6 +219,9 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         xPortGetFreeHeapSize(),
                         xPortGetHeapSize(),
                         xPortGetMinimumEverFreeHeapSize(),
+                        poolStatistics.heapLargestFreeBlock,
+                        poolBlocksInUse,
+                        poolBlocksCapacity,
                         mallocFailedCount,
                         stackOverflowCount);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
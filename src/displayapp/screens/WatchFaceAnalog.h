@@ -33,6 +33,10 @@ namespace Pinetime {
 
         ~WatchFaceAnalog() override;
 
+        bool CanBeSuspended() const override {
+          return true;
+        }
+
         void Refresh() override;
 
       private:
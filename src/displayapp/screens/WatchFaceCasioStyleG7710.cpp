@@ -12,8 +12,15 @@
 #include "components/heartrate/HeartRateController.h"
 #include "components/motion/MotionController.h"
 #include "components/settings/Settings.h"
+#include "displayapp/FontCache.h"
 using namespace Pinetime::Applications::Screens;
 
+namespace {
+  constexpr const char* fontDot40 = "/fonts/lv_font_dots_40.bin";
+  constexpr const char* fontSegment40 = "/fonts/7segments_40.bin";
+  constexpr const char* fontSegment115 = "/fonts/7segments_115.bin";
+}
+
 WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTimeController,
                                                    const Controllers::Battery& batteryController,
                                                    const Controllers::Ble& bleController,
@@ -21,7 +28,7 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
                                                    Controllers::Settings& settingsController,
                                                    Controllers::HeartRateController& heartRateController,
                                                    Controllers::MotionController& motionController,
-                                                   Controllers::FS& filesystem)
+                                                   Components::FontCache& fontCache)
   : currentDateTime {{}},
     batteryIcon(false),
     dateTimeController {dateTimeController},
@@ -30,23 +37,12 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
     notificatioManager {notificatioManager},
     settingsController {settingsController},
     heartRateController {heartRateController},
-    motionController {motionController} {
-
-  lfs_file f = {};
-  if (filesystem.FileOpen(&f, "/fonts/lv_font_dots_40.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_dot40 = lv_font_load("F:/fonts/lv_font_dots_40.bin");
-  }
+    motionController {motionController},
+    fontCache {fontCache} {
 
-  if (filesystem.FileOpen(&f, "/fonts/7segments_40.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_segment40 = lv_font_load("F:/fonts/7segments_40.bin");
-  }
-
-  if (filesystem.FileOpen(&f, "/fonts/7segments_115.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_segment115 = lv_font_load("F:/fonts/7segments_115.bin");
-  }
+  font_dot40 = fontCache.Acquire(fontDot40);
+  font_segment40 = fontCache.Acquire(fontSegment40);
+  font_segment115 = fontCache.Acquire(fontSegment115);
 
   label_battery_value = lv_label_create(lv_scr_act(), nullptr);
   lv_obj_align(label_battery_value, lv_scr_act(), LV_ALIGN_IN_TOP_RIGHT, 0, 0);
@@ -179,15 +175,15 @@ WatchFaceCasioStyleG7710::~WatchFaceCasioStyleG7710() {
   lv_style_reset(&style_border);
 
   if (font_dot40 != nullptr) {
-    lv_font_free(font_dot40);
+    fontCache.Release(font_dot40);
   }
 
   if (font_segment40 != nullptr) {
-    lv_font_free(font_segment40);
+    fontCache.Release(font_segment40);
   }
 
   if (font_segment115 != nullptr) {
-    lv_font_free(font_segment115);
+    fontCache.Release(font_segment115);
   }
 
   lv_obj_clean(lv_scr_act());
@@ -313,22 +309,12 @@ void WatchFaceCasioStyleG7710::Refresh() {
 }
 
 bool WatchFaceCasioStyleG7710::IsAvailable(Pinetime::Controllers::FS& filesystem) {
-  lfs_file file = {};
-
-  if (filesystem.FileOpen(&file, "/fonts/lv_font_dots_40.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/fonts/7segments_40.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/fonts/7segments_115.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
+  auto& resources = filesystem.GetResourcePack();
+  return resources.Exists(fontDot40) && resources.Exists(fontSegment40) && resources.Exists(fontSegment115);
+}
 
-  filesystem.FileClose(&file);
-  return true;
+void WatchFaceCasioStyleG7710::PreloadFonts(Components::FontCache& fontCache) {
+  fontCache.Preload(fontDot40);
+  fontCache.Preload(fontSegment40);
+  fontCache.Preload(fontSegment115);
 }
@@ -22,6 +22,10 @@ namespace Pinetime {
     class MotionController;
   }
 
+  namespace Components {
+    class FontCache;
+  }
+
   namespace Applications {
     namespace Screens {
 
@@ -34,12 +38,17 @@ namespace Pinetime {
                                  Controllers::Settings& settingsController,
                                  Controllers::HeartRateController& heartRateController,
                                  Controllers::MotionController& motionController,
-                                 Controllers::FS& filesystem);
+                                 Components::FontCache& fontCache);
         ~WatchFaceCasioStyleG7710() override;
 
+        bool CanBeSuspended() const override {
+          return true;
+        }
+
         void Refresh() override;
 
         static bool IsAvailable(Pinetime::Controllers::FS& filesystem);
+        static void PreloadFonts(Components::FontCache& fontCache);
 
       private:
         Utility::DirtyValue<uint8_t> batteryPercentRemaining {};
@@ -96,6 +105,7 @@ namespace Pinetime {
         Controllers::MotionController& motionController;
 
         lv_task_t* taskRefresh;
+        Components::FontCache& fontCache;
         lv_font_t* font_dot40 = nullptr;
         lv_font_t* font_segment40 = nullptr;
         lv_font_t* font_segment115 = nullptr;
@@ -115,12 +125,16 @@ namespace Pinetime {
                                                      controllers.settingsController,
                                                      controllers.heartRateController,
                                                      controllers.motionController,
-                                                     controllers.filesystem);
+                                                     controllers.fontCache);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& filesystem) {
         return Screens::WatchFaceCasioStyleG7710::IsAvailable(filesystem);
       }
+
+      static void PreloadFonts(Components::FontCache& fontCache) {
+        Screens::WatchFaceCasioStyleG7710::PreloadFonts(fontCache);
+      }
     };
   }
 }
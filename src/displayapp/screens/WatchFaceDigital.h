@@ -37,6 +37,10 @@ namespace Pinetime {
                          Controllers::SimpleWeatherService& weather);
         ~WatchFaceDigital() override;
 
+        bool CanBeSuspended() const override {
+          return true;
+        }
+
         void Refresh() override;
 
       private:
@@ -9,6 +9,7 @@
 #include "components/ble/BleController.h"
 #include "components/ble/NotificationManager.h"
 #include "components/motion/MotionController.h"
+#include "displayapp/FontCache.h"
 
 using namespace Pinetime::Applications::Screens;
 
@@ -32,6 +33,9 @@ namespace {
 
   constexpr int nLines = WatchFaceInfineat::nLines;
 
+  constexpr const char* fontTeko = "/fonts/teko.bin";
+  constexpr const char* fontBebas = "/fonts/bebas.bin";
+
   constexpr std::array<lv_color_t, nLines> orangeColors = {LV_COLOR_MAKE(0xfd, 0x87, 0x2b),
                                                            LV_COLOR_MAKE(0xdb, 0x33, 0x16),
                                                            LV_COLOR_MAKE(0x6f, 0x10, 0x00),
@@ -125,24 +129,17 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
                                      Controllers::NotificationManager& notificationManager,
                                      Controllers::Settings& settingsController,
                                      Controllers::MotionController& motionController,
-                                     Controllers::FS& filesystem)
+                                     Components::FontCache& fontCache)
   : currentDateTime {{}},
     dateTimeController {dateTimeController},
     batteryController {batteryController},
     bleController {bleController},
     notificationManager {notificationManager},
     settingsController {settingsController},
-    motionController {motionController} {
-  lfs_file f = {};
-  if (filesystem.FileOpen(&f, "/fonts/teko.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_teko = lv_font_load("F:/fonts/teko.bin");
-  }
-
-  if (filesystem.FileOpen(&f, "/fonts/bebas.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_bebas = lv_font_load("F:/fonts/bebas.bin");
-  }
+    motionController {motionController},
+    fontCache {fontCache} {
+  font_teko = fontCache.Acquire(fontTeko);
+  font_bebas = fontCache.Acquire(fontBebas);
 
   // Side Cover
   static constexpr lv_point_t linePoints[nLines][2] = {{{30, 25}, {68, -8}},
@@ -304,10 +301,10 @@ WatchFaceInfineat::~WatchFaceInfineat() {
   lv_task_del(taskRefresh);
 
   if (font_bebas != nullptr) {
-    lv_font_free(font_bebas);
+    fontCache.Release(font_bebas);
   }
   if (font_teko != nullptr) {
-    lv_font_free(font_teko);
+    fontCache.Release(font_teko);
   }
 
   lv_obj_clean(lv_scr_act());
@@ -488,22 +485,11 @@ void WatchFaceInfineat::ToggleBatteryIndicatorColor(bool showSideCover) {
 }
 
 bool WatchFaceInfineat::IsAvailable(Pinetime::Controllers::FS& filesystem) {
-  lfs_file file = {};
-
-  if (filesystem.FileOpen(&file, "/fonts/teko.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/fonts/bebas.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
-
-  filesystem.FileClose(&file);
-  if (filesystem.FileOpen(&file, "/images/pine_small.bin", LFS_O_RDONLY) < 0) {
-    return false;
-  }
+  auto& resources = filesystem.GetResourcePack();
+  return resources.Exists(fontTeko) && resources.Exists(fontBebas) && resources.Exists("/images/pine_small.bin");
+}
 
-  filesystem.FileClose(&file);
-  return true;
+void WatchFaceInfineat::PreloadFonts(Components::FontCache& fontCache) {
+  fontCache.Preload(fontTeko);
+  fontCache.Preload(fontBebas);
 }
@@ -19,6 +19,10 @@ namespace Pinetime {
     class MotionController;
   }
 
+  namespace Components {
+    class FontCache;
+  }
+
   namespace Applications {
     namespace Screens {
 
@@ -31,10 +35,14 @@ namespace Pinetime {
                           Controllers::NotificationManager& notificationManager,
                           Controllers::Settings& settingsController,
                           Controllers::MotionController& motionController,
-                          Controllers::FS& fs);
+                          Components::FontCache& fontCache);
 
         ~WatchFaceInfineat() override;
 
+        bool CanBeSuspended() const override {
+          return true;
+        }
+
         bool OnTouchEvent(TouchEvents event) override;
         bool OnButtonPushed() override;
         void UpdateSelected(lv_obj_t* object, lv_event_t event);
@@ -43,6 +51,7 @@ namespace Pinetime {
         void Refresh() override;
 
         static bool IsAvailable(Pinetime::Controllers::FS& filesystem);
+        static void PreloadFonts(Components::FontCache& fontCache);
 
       private:
         uint32_t savedTick = 0;
@@ -95,6 +104,7 @@ namespace Pinetime {
         void ToggleBatteryIndicatorColor(bool showSideCover);
 
         lv_task_t* taskRefresh;
+        Components::FontCache& fontCache;
         lv_font_t* font_teko = nullptr;
         lv_font_t* font_bebas = nullptr;
       };
@@ -112,12 +122,16 @@ namespace Pinetime {
                                               controllers.notificationManager,
                                               controllers.settingsController,
                                               controllers.motionController,
-                                              controllers.filesystem);
+                                              controllers.fontCache);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& filesystem) {
         return Screens::WatchFaceInfineat::IsAvailable(filesystem);
       }
+
+      static void PreloadFonts(Components::FontCache& fontCache) {
+        Screens::WatchFaceInfineat::PreloadFonts(fontCache);
+      }
     };
   }
 }
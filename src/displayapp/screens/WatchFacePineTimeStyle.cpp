@@ -475,7 +475,7 @@ void WatchFacePineTimeStyle::Refresh() {
     lv_label_set_text_static(notificationIcon, NotificationIcon::GetIcon(notificationState.Get()));
   }
 
-  currentDateTime = dateTimeController.CurrentDateTime();
+  currentDateTime = std::chrono::time_point_cast<std::chrono::seconds>(dateTimeController.CurrentDateTime());
   if (currentDateTime.IsUpdated()) {
     auto hour = dateTimeController.Hours();
     auto minute = dateTimeController.Minutes();
@@ -36,6 +36,10 @@ namespace Pinetime {
                                Controllers::SimpleWeatherService& weather);
         ~WatchFacePineTimeStyle() override;
 
+        bool CanBeSuspended() const override {
+          return true;
+        }
+
         bool OnTouchEvent(TouchEvents event) override;
         bool OnButtonPushed() override;
 
@@ -33,6 +33,10 @@ namespace Pinetime {
                           Controllers::MotionController& motionController);
         ~WatchFaceTerminal() override;
 
+        bool CanBeSuspended() const override {
+          return true;
+        }
+
         void Refresh() override;
 
       private:
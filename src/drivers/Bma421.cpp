@@ -1,4 +1,6 @@
 #include "drivers/Bma421.h"
+#include <algorithm>
+#include <array>
 #include <libraries/delay/nrf_delay.h>
 #include <libraries/log/nrf_log.h>
 #include "drivers/TwiMaster.h"
@@ -32,6 +34,10 @@ namespace {
     [BMA4_ACCEL_RANGE_8G] = 256,  // LSB/g +/- 8g range
     [BMA4_ACCEL_RANGE_16G] = 128  // LSB/g +/- 16g range
   };
+
+  // Headerless FIFO with only the accelerometer enabled: X, Y and Z on 16 bits
+  constexpr size_t fifoFrameSize = 6;
+  constexpr uint8_t fifoFlushCommand = 0xb0;
 }
 
 Bma421::Bma421(TwiMaster& twiMaster, uint8_t twiAddress) : twiMaster {twiMaster}, deviceAddress {twiAddress} {
@@ -68,7 +74,8 @@ void Bma421::Init() {
   if (ret != BMA4_OK)
     return;
 
-  ret = bma4_set_interrupt_mode(BMA4_LATCH_MODE, &bma);
+  // The interrupt pin follows the FIFO level, so that it's lowered as soon as the FIFO is read
+  ret = bma4_set_interrupt_mode(BMA4_NON_LATCH_MODE, &bma);
   if (ret != BMA4_OK)
     return;
 
@@ -92,7 +99,37 @@ void Bma421::Init() {
   if (ret != BMA4_OK)
     return;
 
+  ret = bma4_set_fifo_config(BMA4_FIFO_HEADER, BMA4_DISABLE, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  ret = bma4_set_fifo_config(BMA4_FIFO_ACCEL, BMA4_ENABLE, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  ret = bma4_set_accel_fifo_filter_data(BMA4_ENABLE, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  ret = bma4_set_fifo_down_accel(fifoDownsampling, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  ret = bma4_set_fifo_wm(fifoWatermark * fifoFrameSize, &bma);
+  if (ret != BMA4_OK)
+    return;
+
+  struct bma4_int_pin_config pinConfig = {.edge_ctrl = BMA4_LEVEL_TRIGGER,
+                                          .lvl = BMA4_ACTIVE_HIGH,
+                                          .od = BMA4_PUSH_PULL,
+                                          .output_en = BMA4_OUTPUT_ENABLE,
+                                          .input_en = BMA4_INPUT_DISABLE};
+  ret = bma4_set_int_pin_config(&pinConfig, BMA4_INTR1_MAP, &bma);
+  if (ret != BMA4_OK)
+    return;
+
   isOk = true;
+  SetFifoInterrupt(true);
 }
 
 void Bma421::Reset() {
@@ -108,26 +145,66 @@ void Bma421::Write(uint8_t registerAddress, const uint8_t* data, size_t size) {
   twiMaster.Write(deviceAddress, registerAddress, data, size);
 }
 
-Bma421::Values Bma421::Process() {
+size_t Bma421::ReadFifo(Acceleration* samples, size_t maxSamples) {
   if (not isOk)
-    return {};
-  struct bma4_accel rawData;
-  struct bma4_accel data;
-  bma4_read_accel_xyz(&rawData, &bma);
-
-  // Scale the measured ADC counts to units of 'binary milli-g'
-  // where 1g = 1024 'binary milli-g' units.
-  // See https://github.com/InfiniTimeOrg/InfiniTime/pull/1950 for
-  // discussion of why we opted for scaling to 1024 rather than 1000.
-  data.x = 1024 * rawData.x / accelScaleFactors[accel_conf.range];
-  data.y = 1024 * rawData.y / accelScaleFactors[accel_conf.range];
-  data.z = 1024 * rawData.z / accelScaleFactors[accel_conf.range];
+    return 0;
+
+  uint16_t length = 0;
+  if (bma4_get_fifo_length(&length, &bma) != BMA4_OK || length == 0)
+    return 0;
+
+  maxSamples = std::min(maxSamples, maxFifoSamples);
+  if (length > maxSamples * fifoFrameSize) {
+    // The FIFO was not read for a while, these samples are too old to be useful
+    bma4_set_command_register(fifoFlushCommand, &bma);
+    return 0;
+  }
+
+  std::array<uint8_t, maxFifoSamples * fifoFrameSize> buffer;
+  struct bma4_fifo_frame fifo = {};
+  fifo.data = buffer.data();
+  fifo.length = length;
+  if (bma4_read_fifo_data(&fifo, &bma) != BMA4_OK)
+    return 0;
+
+  std::array<struct bma4_accel, maxFifoSamples> rawData;
+  uint16_t nbSamples = maxSamples;
+  if (bma4_extract_accel(rawData.data(), &nbSamples, &fifo, &bma) != BMA4_OK)
+    return 0;
 
+  for (size_t i = 0; i < nbSamples; i++) {
+    // Scale the measured ADC counts to units of 'binary milli-g'
+    // where 1g = 1024 'binary milli-g' units.
+    // See https://github.com/InfiniTimeOrg/InfiniTime/pull/1950 for
+    // discussion of why we opted for scaling to 1024 rather than 1000.
+    int16_t x = 1024 * rawData[i].x / accelScaleFactors[accel_conf.range];
+    int16_t y = 1024 * rawData[i].y / accelScaleFactors[accel_conf.range];
+    int16_t z = 1024 * rawData[i].z / accelScaleFactors[accel_conf.range];
+
+    // X and Y axis are swapped because of the way the sensor is mounted in the PineTime
+    samples[i] = {y, x, z};
+  }
+  return nbSamples;
+}
+
+uint32_t Bma421::ReadStepCount() {
+  if (not isOk)
+    return 0;
   uint32_t steps = 0;
   bma423_step_counter_output(&steps, &bma);
+  return steps;
+}
+
+void Bma421::SetFifoInterrupt(bool enabled) {
+  if (not isOk || enabled == fifoInterruptEnabled)
+    return;
 
-  // X and Y axis are swapped because of the way the sensor is mounted in the PineTime
-  return {steps, data.y, data.x, data.z};
+  if (enabled) {
+    // Start from an empty FIFO so that the interrupt pin is low and rises at the next watermark
+    bma4_set_command_register(fifoFlushCommand, &bma);
+  }
+  bma423_map_interrupt(BMA4_INTR1_MAP, BMA4_FIFO_WM_INT, enabled ? BMA4_ENABLE : BMA4_DISABLE, &bma);
+  fifoInterruptEnabled = enabled;
 }
 
 bool Bma421::IsOk() const {
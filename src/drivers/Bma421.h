@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <drivers/Bma421_C/bma4_defs.h>
 
 namespace Pinetime {
@@ -9,13 +10,19 @@ namespace Pinetime {
     public:
       enum class DeviceTypes : uint8_t { Unknown, BMA421, BMA425 };
 
-      struct Values {
-        uint32_t steps;
+      struct Acceleration {
         int16_t x;
         int16_t y;
         int16_t z;
       };
 
+      // The accelerometer runs at 100Hz, and every 8th (filtered) sample is stored in the FIFO, i.e. one every 80ms.
+      // The interrupt pin is raised when the FIFO contains fifoWatermark samples.
+      static constexpr uint8_t fifoDownsampling = 3;
+      static constexpr uint32_t fifoSamplePeriodMs = 80;
+      static constexpr size_t fifoWatermark = 5;
+      static constexpr size_t maxFifoSamples = 16;
+
       Bma421(TwiMaster& twiMaster, uint8_t twiAddress);
       Bma421(const Bma421&) = delete;
       Bma421& operator=(const Bma421&) = delete;
@@ -26,9 +33,16 @@ namespace Pinetime {
       /// Init() method to allow the caller to uninit and then reinit the TWI device after the softreset.
       void SoftReset();
       void Init();
-      Values Process();
+
+      /// Reads all the samples accumulated in the FIFO in a single transfer, oldest first, and returns how many were read.
+      /// If the FIFO contains more than maxSamples, it is flushed and no sample is returned.
+      size_t ReadFifo(Acceleration* samples, size_t maxSamples);
+      uint32_t ReadStepCount();
       void ResetStepCounter();
 
+      /// The FIFO keeps being filled when the interrupt is disabled, it is flushed when the interrupt is enabled again.
+      void SetFifoInterrupt(bool enabled);
+
       void Read(uint8_t registerAddress, uint8_t* buffer, size_t size);
       void Write(uint8_t registerAddress, const uint8_t* data, size_t size);
 
@@ -44,6 +58,7 @@ namespace Pinetime {
       struct bma4_accel_config accel_conf; // Store the device configuration for later reference.
       bool isOk = false;
       bool isResetOk = false;
+      bool fifoInterruptEnabled = false;
       DeviceTypes deviceType = DeviceTypes::Unknown;
     };
   }
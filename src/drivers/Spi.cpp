@@ -1,20 +1,80 @@
 #include "drivers/Spi.h"
 #include <hal/nrf_gpio.h>
 #include <nrfx_log.h>
+#include <algorithm>
 
 using namespace Pinetime::Drivers;
 
-Spi::Spi(SpiMaster& spiMaster, uint8_t pinCsn) : spiMaster {spiMaster}, pinCsn {pinCsn} {
+Spi::Spi(SpiMaster& spiMaster, uint8_t pinCsn, SpiMaster::Priorities priority)
+  : spiMaster {spiMaster}, pinCsn {pinCsn}, priority {priority} {
   nrf_gpio_cfg_output(pinCsn);
   nrf_gpio_pin_set(pinCsn);
+
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
+  transferDone = xSemaphoreCreateBinary();
+  ASSERT(transferDone != nullptr);
 }
 
-bool Spi::Write(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
-  return spiMaster.Write(pinCsn, data, size, preTransactionHook);
+bool Spi::Write(const uint8_t* data, size_t size) {
+  if (data == nullptr) {
+    return false;
+  }
+  SpiMaster::Transaction transaction;
+  transaction.txData = data;
+  transaction.txSize = size;
+  return Transfer(transaction);
 }
 
 bool Spi::Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
-  return spiMaster.Read(pinCsn, cmd, cmdSize, data, dataSize);
+  SpiMaster::Transaction transaction;
+  if (cmdSize <= SpiMaster::maxCommandSize) {
+    std::copy(cmd, cmd + cmdSize, transaction.command.begin());
+    transaction.commandSize = cmdSize;
+  } else {
+    transaction.txData = cmd;
+    transaction.txSize = cmdSize;
+  }
+  transaction.rxData = data;
+  transaction.rxSize = dataSize;
+  return Transfer(transaction);
+}
+
+bool Spi::WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
+  if (cmdSize > SpiMaster::maxCommandSize) {
+    return false;
+  }
+  SpiMaster::Transaction transaction;
+  std::copy(cmd, cmd + cmdSize, transaction.command.begin());
+  transaction.commandSize = cmdSize;
+  transaction.txData = data;
+  transaction.txSize = dataSize;
+  return Transfer(transaction);
+}
+
+bool Spi::Transfer(const SpiMaster::Transaction& transaction) {
+  SpiMaster::Transaction t = transaction;
+  t.pinCsn = pinCsn;
+  if (t.onComplete != nullptr) {
+    return spiMaster.Enqueue(t, priority);
+  }
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  t.onComplete = OnTransferComplete;
+  t.onCompleteContext = this;
+  bool ok = spiMaster.Enqueue(t, priority);
+  if (ok) {
+    xSemaphoreTake(transferDone, portMAX_DELAY);
+  }
+  xSemaphoreGive(mutex);
+  return ok;
+}
+
+void Spi::OnTransferComplete(void* instance) {
+  auto* spi = static_cast<Spi*>(instance);
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(spi->transferDone, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 void Spi::Sleep() {
@@ -22,10 +82,6 @@ void Spi::Sleep() {
   NRF_LOG_INFO("[SPI] Sleep")
 }
 
-bool Spi::WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
-  return spiMaster.WriteCmdAndBuffer(pinCsn, cmd, cmdSize, data, dataSize);
-}
-
 bool Spi::Init() {
   nrf_gpio_cfg_output(pinCsn);
   nrf_gpio_pin_set(pinCsn);
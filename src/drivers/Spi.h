@@ -1,29 +1,39 @@
 #pragma once
 #include <cstdint>
 #include <cstddef>
-#include <functional>
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include "drivers/SpiMaster.h"
 
 namespace Pinetime {
   namespace Drivers {
     class Spi {
     public:
-      Spi(SpiMaster& spiMaster, uint8_t pinCsn);
+      Spi(SpiMaster& spiMaster, uint8_t pinCsn, SpiMaster::Priorities priority = SpiMaster::Priorities::Normal);
       Spi(const Spi&) = delete;
       Spi& operator=(const Spi&) = delete;
       Spi(Spi&&) = delete;
       Spi& operator=(Spi&&) = delete;
 
       bool Init();
-      bool Write(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
+      bool Write(const uint8_t* data, size_t size);
       bool Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
       bool WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
+      // Queues the transaction on the bus for this device.
+      // Without completion callback, blocks until the transaction is done.
+      // Otherwise, returns immediately and the buffers must stay valid until the callback is called.
+      bool Transfer(const SpiMaster::Transaction& transaction);
       void Sleep();
       void Wakeup();
 
     private:
+      static void OnTransferComplete(void* instance);
+
       SpiMaster& spiMaster;
       uint8_t pinCsn;
+      SpiMaster::Priorities priority;
+      SemaphoreHandle_t mutex = nullptr;
+      SemaphoreHandle_t transferDone = nullptr;
     };
   }
 }
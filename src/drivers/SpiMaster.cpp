@@ -1,6 +1,7 @@
 #include "drivers/SpiMaster.h"
 #include <hal/nrf_gpio.h>
 #include <hal/nrf_spim.h>
+#include <hal/nrf_timer.h>
 #include <nrfx_log.h>
 #include <algorithm>
 
@@ -10,9 +11,11 @@ SpiMaster::SpiMaster(const SpiMaster::SpiModule spi, const SpiMaster::Parameters
 }
 
 bool SpiMaster::Init() {
-  if (mutex == nullptr) {
-    mutex = xSemaphoreCreateBinary();
-    ASSERT(mutex != nullptr);
+  for (auto& queue : queues) {
+    if (queue.freeSlots == nullptr) {
+      queue.freeSlots = xSemaphoreCreateCounting(TransactionQueue::size, TransactionQueue::size);
+      ASSERT(queue.freeSlots != nullptr);
+    }
   }
 
   /* Configure GPIO pins used for pselsck, pselmosi, pselmiso and pselss for SPI0 */
@@ -90,71 +93,235 @@ bool SpiMaster::Init() {
   NRFX_IRQ_PRIORITY_SET(SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn, 2);
   NRFX_IRQ_ENABLE(SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn);
 
-  xSemaphoreGive(mutex);
+  SetupListTransfer();
+
   return true;
 }
 
-void SpiMaster::SetupWorkaroundForErratum58() {
-  nrfx_gpiote_pin_t pin = spiBaseAddress->PSEL.SCK;
-  nrfx_gpiote_in_config_t gpioteCfg = {.sense = NRF_GPIOTE_POLARITY_TOGGLE,
-                                       .pull = NRF_GPIO_PIN_NOPULL,
-                                       .is_watcher = false,
-                                       .hi_accuracy = true,
-                                       .skip_gpio_setup = true};
-  if (!workaroundActive) {
-    // Create an event when SCK toggles.
-    APP_ERROR_CHECK(nrfx_gpiote_in_init(pin, &gpioteCfg, NULL));
-    nrfx_gpiote_in_event_enable(pin, false);
-
-    // Stop the spim instance when SCK toggles.
-    nrf_ppi_channel_endpoint_setup(workaroundPpi, nrfx_gpiote_in_event_addr_get(pin), spiBaseAddress->TASKS_STOP);
-    nrf_ppi_channel_enable(workaroundPpi);
-  }
+void SpiMaster::SetupListTransfer() {
+  // TIMER2 counts the END events of a list transfer:
+  //  - COMPARE[0] (nbChunks - 1) disables the END -> START channel, so the last chunk isn't followed by another one
+  //  - COMPARE[1] (nbChunks) fires the only interrupt of the transfer
+  NRF_TIMER2->TASKS_STOP = 1;
+  NRF_TIMER2->MODE = TIMER_MODE_MODE_LowPowerCounter << TIMER_MODE_MODE_Pos;
+  NRF_TIMER2->BITMODE = TIMER_BITMODE_BITMODE_16Bit << TIMER_BITMODE_BITMODE_Pos;
+  NRF_TIMER2->SHORTS = TIMER_SHORTS_COMPARE1_STOP_Msk;
+  NRF_TIMER2->INTENSET = TIMER_INTENSET_COMPARE1_Msk;
+
+  nrf_ppi_channel_endpoint_setup(listStartPpi,
+                                 reinterpret_cast<uint32_t>(&spiBaseAddress->EVENTS_END),
+                                 reinterpret_cast<uint32_t>(&spiBaseAddress->TASKS_START));
+  nrf_ppi_channel_include_in_group(listStartPpi, listPpiGroup);
+  nrf_ppi_group_disable(listPpiGroup);
+
+  nrf_ppi_channel_endpoint_setup(listCountPpi,
+                                 reinterpret_cast<uint32_t>(&spiBaseAddress->EVENTS_END),
+                                 reinterpret_cast<uint32_t>(&NRF_TIMER2->TASKS_COUNT));
+  nrf_ppi_channel_disable(listCountPpi);
+
+  nrf_ppi_channel_endpoint_setup(listStopPpi,
+                                 reinterpret_cast<uint32_t>(&NRF_TIMER2->EVENTS_COMPARE[0]),
+                                 reinterpret_cast<uint32_t>(&NRF_PPI->TASKS_CHG[listPpiGroup].DIS));
+  nrf_ppi_channel_enable(listStopPpi);
+
+  NRFX_IRQ_PRIORITY_SET(TIMER2_IRQn, 2);
+  NRFX_IRQ_ENABLE(TIMER2_IRQn);
+}
 
-  spiBaseAddress->EVENTS_END = 0;
+size_t SpiMaster::ListTransferLayout(size_t size, size_t& chunkSize) {
+  // Look for the largest chunk size that splits the buffer evenly, so that all of it is sent as a single list.
+  // If there's none, the list is made of full-size chunks and the remainder is sent as a regular transfer.
+  if (size < 2 * minListChunkSize) {
+    chunkSize = maxChunkSize;
+    return size / maxChunkSize;
+  }
+  for (size_t candidate = maxChunkSize; candidate >= minListChunkSize; candidate--) {
+    if (size % candidate == 0) {
+      chunkSize = candidate;
+      return size / candidate;
+    }
+  }
+  chunkSize = maxChunkSize;
+  return size / maxChunkSize;
+}
 
-  // Disable IRQ
+void SpiMaster::PrepareListTx(uint32_t bufferAddress, size_t chunkSize, size_t nbChunks) {
+  // STARTED and END would otherwise interrupt the CPU for every chunk
   spiBaseAddress->INTENCLR = (1 << 6);
-  spiBaseAddress->INTENCLR = (1 << 1);
   spiBaseAddress->INTENCLR = (1 << 19);
-  workaroundActive = true;
+
+  PrepareTx(bufferAddress, chunkSize);
+  spiBaseAddress->TXD.LIST = SPIM_TXD_LIST_LIST_ArrayList << SPIM_TXD_LIST_LIST_Pos;
+
+  NRF_TIMER2->TASKS_CLEAR = 1;
+  NRF_TIMER2->CC[0] = nbChunks - 1;
+  NRF_TIMER2->CC[1] = nbChunks;
+  NRF_TIMER2->EVENTS_COMPARE[0] = 0;
+  NRF_TIMER2->EVENTS_COMPARE[1] = 0;
+  NRF_TIMER2->TASKS_START = 1;
+
+  nrf_ppi_channel_enable(listCountPpi);
+  nrf_ppi_group_enable(listPpiGroup);
+  listTransferActive = true;
 }
 
-void SpiMaster::DisableWorkaroundForErratum58() {
-  nrfx_gpiote_pin_t pin = spiBaseAddress->PSEL.SCK;
-  if (workaroundActive) {
-    nrfx_gpiote_in_uninit(pin);
-    nrf_ppi_channel_disable(workaroundPpi);
-  }
-  spiBaseAddress->EVENTS_END = 0;
+void SpiMaster::StopListTransfer() {
+  nrf_ppi_group_disable(listPpiGroup);
+  nrf_ppi_channel_disable(listCountPpi);
+  NRF_TIMER2->TASKS_STOP = 1;
+  listTransferActive = false;
 
-  // Enable IRQ
+  spiBaseAddress->TXD.LIST = 0;
+  spiBaseAddress->EVENTS_END = 0;
+  spiBaseAddress->EVENTS_STARTED = 0;
   spiBaseAddress->INTENSET = (1 << 6);
-  spiBaseAddress->INTENSET = (1 << 1);
   spiBaseAddress->INTENSET = (1 << 19);
-  workaroundActive = false;
+}
+
+void SpiMaster::StartNextChunk() {
+  size_t transferSize;
+  if (currentBufferIsRx) {
+    transferSize = std::min(maxChunkSize, (size_t) currentBufferSize);
+    PrepareRx(currentBufferAddr, transferSize);
+  } else {
+    size_t chunkSize;
+    auto nbChunks = ListTransferLayout(currentBufferSize, chunkSize);
+    if (nbChunks > 1) {
+      PrepareListTx(currentBufferAddr, chunkSize, nbChunks);
+      transferSize = chunkSize * nbChunks;
+    } else {
+      transferSize = std::min(maxChunkSize, (size_t) currentBufferSize);
+      PrepareTx(currentBufferAddr, transferSize);
+    }
+  }
+  currentBufferAddr = currentBufferAddr + transferSize;
+  currentBufferSize = currentBufferSize - transferSize;
+
+  spiBaseAddress->TASKS_START = 1;
+}
+
+bool SpiMaster::Enqueue(const Transaction& transaction, Priorities priority) {
+  if (transaction.commandSize > maxCommandSize) {
+    return false;
+  }
+  bool isEmpty = transaction.commandSize == 0 && (transaction.txData == nullptr || transaction.txSize == 0) &&
+                 (transaction.rxData == nullptr || transaction.rxSize == 0);
+  if (isEmpty) {
+    return false;
+  }
+
+  auto& queue = queues[static_cast<uint8_t>(priority)];
+  auto ok = xSemaphoreTake(queue.freeSlots, portMAX_DELAY);
+  ASSERT(ok == pdTRUE);
+
+  taskENTER_CRITICAL();
+  queue.transactions[(queue.head + queue.count) % TransactionQueue::size] = transaction;
+  queue.count++;
+  if (!busy) {
+    StartNextTransaction();
+  }
+  taskEXIT_CRITICAL();
+
+  return true;
+}
+
+// Must be called with the SPI interrupt masked (critical section or SPI interrupt itself)
+bool SpiMaster::StartNextTransaction() {
+  for (auto& queue : queues) {
+    if (queue.count > 0) {
+      current = queue.transactions[queue.head];
+      queue.head = (queue.head + 1) % TransactionQueue::size;
+      queue.count--;
+      currentQueue = &queue;
+      busy = true;
+
+      nrf_gpio_pin_clear(current.pinCsn);
+      // Empty transactions are rejected by Enqueue(), there's always at least one phase to start
+      StartPhase(Phases::Command);
+      return true;
+    }
+  }
+  busy = false;
+  return false;
+}
+
+// Starts the first non-empty phase from the given one. Returns false when there's nothing left to transfer.
+bool SpiMaster::StartPhase(Phases phase) {
+  while (true) {
+    currentPhase = phase;
+    switch (phase) {
+      case Phases::Command:
+        if (current.commandSize > 0) {
+          if (current.phaseHook != nullptr) {
+            current.phaseHook(current.phaseHookContext, false);
+          }
+          currentBufferAddr = reinterpret_cast<uint32_t>(current.command.data());
+          currentBufferSize = current.commandSize;
+          currentBufferIsRx = false;
+          StartNextChunk();
+          return true;
+        }
+        phase = Phases::Transmit;
+        break;
+      case Phases::Transmit:
+        if (current.txData != nullptr && current.txSize > 0) {
+          if (current.phaseHook != nullptr) {
+            current.phaseHook(current.phaseHookContext, true);
+          }
+          currentBufferAddr = reinterpret_cast<uint32_t>(current.txData);
+          currentBufferSize = current.txSize;
+          currentBufferIsRx = false;
+          StartNextChunk();
+          return true;
+        }
+        phase = Phases::Receive;
+        break;
+      case Phases::Receive:
+        // Single byte reads hit nRF52832 anomaly 58 (an extra byte is clocked out).
+        // This is harmless here as CS is released right after the read.
+        if (current.rxData != nullptr && current.rxSize > 0) {
+          currentBufferAddr = reinterpret_cast<uint32_t>(current.rxData);
+          currentBufferSize = current.rxSize;
+          currentBufferIsRx = true;
+          StartNextChunk();
+          return true;
+        }
+        return false;
+    }
+  }
+}
+
+void SpiMaster::CompleteTransaction(BaseType_t* xHigherPriorityTaskWoken) {
+  nrf_gpio_pin_set(current.pinCsn);
+  currentBufferAddr = 0;
+  xSemaphoreGiveFromISR(currentQueue->freeSlots, xHigherPriorityTaskWoken);
+  if (current.onComplete != nullptr) {
+    current.onComplete(current.onCompleteContext);
+  }
 }
 
 void SpiMaster::OnEndEvent() {
-  if (currentBufferAddr == 0) {
+  if (!busy) {
     return;
   }
 
-  auto s = currentBufferSize;
-  if (s > 0) {
-    auto currentSize = std::min((size_t) 255, s);
-    PrepareTx(currentBufferAddr, currentSize);
-    currentBufferAddr = currentBufferAddr + currentSize;
-    currentBufferSize = currentBufferSize - currentSize;
+  if (listTransferActive) {
+    StopListTransfer();
+  }
 
-    spiBaseAddress->TASKS_START = 1;
-  } else {
-    nrf_gpio_pin_set(this->pinCsn);
-    currentBufferAddr = 0;
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xSemaphoreGiveFromISR(mutex, &xHigherPriorityTaskWoken);
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  if (currentBufferSize > 0) {
+    StartNextChunk();
+    return;
   }
+
+  if (currentPhase != Phases::Receive && StartPhase(static_cast<Phases>(static_cast<uint8_t>(currentPhase) + 1))) {
+    return;
+  }
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  CompleteTransaction(&xHigherPriorityTaskWoken);
+  StartNextTransaction();
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 void SpiMaster::OnStartedEvent() {
@@ -180,80 +347,15 @@ void SpiMaster::PrepareRx(const uint32_t bufferAddress, const size_t size) {
   spiBaseAddress->EVENTS_END = 0;
 }
 
-bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
-  if (data == nullptr)
-    return false;
-  auto ok = xSemaphoreTake(mutex, portMAX_DELAY);
-  ASSERT(ok == true);
-
-  this->pinCsn = pinCsn;
-
-  if (size == 1) {
-    SetupWorkaroundForErratum58();
-  } else {
-    DisableWorkaroundForErratum58();
-  }
-
-  if (preTransactionHook != nullptr) {
-    preTransactionHook();
-  }
-  nrf_gpio_pin_clear(this->pinCsn);
-
-  currentBufferAddr = (uint32_t) data;
-  currentBufferSize = size;
-
-  auto currentSize = std::min((size_t) 255, (size_t) currentBufferSize);
-  PrepareTx(currentBufferAddr, currentSize);
-  currentBufferSize = currentBufferSize - currentSize;
-  currentBufferAddr = currentBufferAddr + currentSize;
-  spiBaseAddress->TASKS_START = 1;
-
-  if (size == 1) {
-    while (spiBaseAddress->EVENTS_END == 0)
-      ;
-    nrf_gpio_pin_set(this->pinCsn);
-    currentBufferAddr = 0;
-
-    DisableWorkaroundForErratum58();
-
-    xSemaphoreGive(mutex);
+void SpiMaster::Sleep() {
+  // Each queued transaction holds a slot until it's completed: taking all of them waits for the pending transfers.
+  // The slots are kept until Wakeup() so that no transaction is started while the SPIM is disabled.
+  for (auto& queue : queues) {
+    for (size_t i = 0; i < TransactionQueue::size; i++) {
+      xSemaphoreTake(queue.freeSlots, portMAX_DELAY);
+    }
   }
 
-  return true;
-}
-
-bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
-  xSemaphoreTake(mutex, portMAX_DELAY);
-
-  this->pinCsn = pinCsn;
-  DisableWorkaroundForErratum58();
-  spiBaseAddress->INTENCLR = (1 << 6);
-  spiBaseAddress->INTENCLR = (1 << 1);
-  spiBaseAddress->INTENCLR = (1 << 19);
-
-  nrf_gpio_pin_clear(this->pinCsn);
-
-  currentBufferAddr = 0;
-  currentBufferSize = 0;
-
-  PrepareTx((uint32_t) cmd, cmdSize);
-  spiBaseAddress->TASKS_START = 1;
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-
-  PrepareRx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
-
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-  nrf_gpio_pin_set(this->pinCsn);
-
-  xSemaphoreGive(mutex);
-
-  return true;
-}
-
-void SpiMaster::Sleep() {
   while (spiBaseAddress->ENABLE != 0) {
     spiBaseAddress->ENABLE = (SPIM_ENABLE_ENABLE_Disabled << SPIM_ENABLE_ENABLE_Pos);
   }
@@ -266,36 +368,10 @@ void SpiMaster::Sleep() {
 
 void SpiMaster::Wakeup() {
   Init();
+  for (auto& queue : queues) {
+    for (size_t i = 0; i < TransactionQueue::size; i++) {
+      xSemaphoreGive(queue.freeSlots);
+    }
+  }
   NRF_LOG_INFO("[SPIMASTER] Wakeup");
 }
-
-bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
-  xSemaphoreTake(mutex, portMAX_DELAY);
-
-  this->pinCsn = pinCsn;
-  DisableWorkaroundForErratum58();
-  spiBaseAddress->INTENCLR = (1 << 6);
-  spiBaseAddress->INTENCLR = (1 << 1);
-  spiBaseAddress->INTENCLR = (1 << 19);
-
-  nrf_gpio_pin_clear(this->pinCsn);
-
-  currentBufferAddr = 0;
-  currentBufferSize = 0;
-
-  PrepareTx((uint32_t) cmd, cmdSize);
-  spiBaseAddress->TASKS_START = 1;
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-
-  PrepareTx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
-
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-  nrf_gpio_pin_set(this->pinCsn);
-
-  xSemaphoreGive(mutex);
-
-  return true;
-}
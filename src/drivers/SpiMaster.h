@@ -1,12 +1,12 @@
 #pragma once
+#include <array>
 #include <cstddef>
 #include <cstdint>
-#include <functional>
 
 #include <FreeRTOS.h>
 #include <semphr.h>
 #include <task.h>
-#include "nrfx_gpiote.h"
+#include <nrf.h>
 #include "nrf_ppi.h"
 
 namespace Pinetime {
@@ -18,6 +18,10 @@ namespace Pinetime {
       enum class Modes : uint8_t { Mode0, Mode1, Mode2, Mode3 };
       enum class Frequencies : uint8_t { Freq8Mhz };
 
+      // High priority transactions are always started before the normal priority ones waiting in the queue.
+      // The transaction in progress is never interrupted.
+      enum class Priorities : uint8_t { High, Normal };
+
       struct Parameters {
         BitOrder bitOrder;
         Modes mode;
@@ -27,6 +31,30 @@ namespace Pinetime {
         uint8_t pinMISO;
       };
 
+      // Called once the last byte of a transaction has been transferred, from the SPI interrupt
+      using TransferCompleteCallback = void (*)(void* context);
+      // Called from the SPI interrupt before the command (isData = false) and data (isData = true) phases,
+      // e.g. to drive the D/C line of a display controller
+      using PhaseHook = void (*)(void* context, bool isData);
+
+      static constexpr size_t maxCommandSize = 8;
+
+      // A transaction is made of up to 3 phases, all executed with CS asserted:
+      // command (copied into the descriptor), data to send, and data to receive.
+      struct Transaction {
+        uint8_t pinCsn;
+        std::array<uint8_t, maxCommandSize> command;
+        uint8_t commandSize = 0;
+        const uint8_t* txData = nullptr;
+        size_t txSize = 0;
+        uint8_t* rxData = nullptr;
+        size_t rxSize = 0;
+        PhaseHook phaseHook = nullptr;
+        void* phaseHookContext = nullptr;
+        TransferCompleteCallback onComplete = nullptr;
+        void* onCompleteContext = nullptr;
+      };
+
       SpiMaster(const SpiModule spi, const Parameters& params);
       SpiMaster(const SpiMaster&) = delete;
       SpiMaster& operator=(const SpiMaster&) = delete;
@@ -34,34 +62,65 @@ namespace Pinetime {
       SpiMaster& operator=(SpiMaster&&) = delete;
 
       bool Init();
-      bool Write(uint8_t pinCsn, const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
-      bool Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
 
-      bool WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
+      // Queues the transaction and returns immediately. The buffers it references must stay valid until onComplete is called.
+      // Blocks only if the queue of the given priority is full.
+      bool Enqueue(const Transaction& transaction, Priorities priority);
 
       void OnStartedEvent();
       void OnEndEvent();
 
+      // Sleep() waits for the queued transactions to complete. Enqueue() blocks from Sleep() until Wakeup().
       void Sleep();
       void Wakeup();
 
     private:
-      void SetupWorkaroundForErratum58();
-      void DisableWorkaroundForErratum58();
+      enum class Phases : uint8_t { Command, Transmit, Receive };
+
+      struct TransactionQueue {
+        static constexpr size_t size = 4;
+        std::array<Transaction, size> transactions;
+        size_t head = 0;
+        size_t count = 0;
+        SemaphoreHandle_t freeSlots = nullptr;
+      };
+
       void PrepareTx(const volatile uint32_t bufferAddress, const volatile size_t size);
       void PrepareRx(const volatile uint32_t bufferAddress, const volatile size_t size);
+      void PrepareListTx(uint32_t bufferAddress, size_t chunkSize, size_t nbChunks);
+      void SetupListTransfer();
+      void StopListTransfer();
+      void StartNextChunk();
+      static size_t ListTransferLayout(size_t size, size_t& chunkSize);
+
+      bool StartNextTransaction();
+      bool StartPhase(Phases phase);
+      void CompleteTransaction(BaseType_t* xHigherPriorityTaskWoken);
 
       NRF_SPIM_Type* spiBaseAddress;
-      uint8_t pinCsn;
 
       SpiMaster::SpiModule spi;
       SpiMaster::Parameters params;
 
+      std::array<TransactionQueue, 2> queues;
+      Transaction current;
+      TransactionQueue* currentQueue = nullptr;
+      Phases currentPhase = Phases::Command;
+      volatile bool busy = false;
+
       volatile uint32_t currentBufferAddr = 0;
       volatile size_t currentBufferSize = 0;
-      SemaphoreHandle_t mutex = nullptr;
-      static constexpr nrf_ppi_channel_t workaroundPpi = NRF_PPI_CHANNEL0;
-      bool workaroundActive = false;
+      volatile bool currentBufferIsRx = false;
+
+      // EasyDMA list mode: END restarts the SPIM and is counted by TIMER2 until the whole list is sent
+      // Channels 1 and 2 are used by the BrightnessController, nimble uses channels 4, 5 and 17 to 31
+      static constexpr nrf_ppi_channel_t listStartPpi = NRF_PPI_CHANNEL6;
+      static constexpr nrf_ppi_channel_t listCountPpi = NRF_PPI_CHANNEL7;
+      static constexpr nrf_ppi_channel_t listStopPpi = NRF_PPI_CHANNEL8;
+      static constexpr nrf_ppi_channel_group_t listPpiGroup = NRF_PPI_CHANNEL_GROUP0;
+      static constexpr size_t maxChunkSize = 255;
+      static constexpr size_t minListChunkSize = 128;
+      volatile bool listTransferActive = false;
     };
   }
 }
@@ -2,11 +2,15 @@
 #include <hal/nrf_gpio.h>
 #include <libraries/delay/nrf_delay.h>
 #include <libraries/log/nrf_log.h>
+#include <algorithm>
+#include <cstring>
 #include "drivers/Spi.h"
 
 using namespace Pinetime::Drivers;
 
-SpiNorFlash::SpiNorFlash(Spi& spi) : spi {spi} {
+SpiNorFlash::SpiNorFlash(Spi& spi, ReadModes readMode) : spi {spi}, readMode {readMode} {
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
 }
 
 void SpiNorFlash::Init() {
@@ -21,8 +25,13 @@ void SpiNorFlash::Uninit() {
 }
 
 void SpiNorFlash::Sleep() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  FlushPageBuffer();
+  WaitForCompletion();
+  xSemaphoreGive(mutex);
+
   auto cmd = static_cast<uint8_t>(Commands::DeepPowerDown);
-  spi.Write(&cmd, sizeof(uint8_t), nullptr);
+  spi.Write(&cmd, sizeof(uint8_t));
   NRF_LOG_INFO("[SpiNorFlash] Sleep")
 }
 
@@ -71,12 +80,23 @@ uint8_t SpiNorFlash::ReadConfigurationRegister() {
 }
 
 void SpiNorFlash::Read(uint32_t address, uint8_t* buffer, size_t size) {
-  static constexpr uint8_t cmdSize = 4;
-  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::Read),
-                          static_cast<uint8_t>(address >> 16U),
-                          static_cast<uint8_t>(address >> 8U),
-                          static_cast<uint8_t>(address)};
+  // The whole range is read in a single command: the SPI driver splits the reception in DMA chunks while CS stays asserted.
+  // Fast Read is followed by a dummy byte after the address
+  const bool fastRead = readMode == ReadModes::Fast;
+  const uint8_t cmdSize = fastRead ? 5 : 4;
+  uint8_t cmd[5] = {static_cast<uint8_t>(fastRead ? Commands::FastRead : Commands::Read),
+                    static_cast<uint8_t>(address >> 16U),
+                    static_cast<uint8_t>(address >> 8U),
+                    static_cast<uint8_t>(address),
+                    0x00};
+
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (pageBufferSize > 0 && pageBufferAddress < address + size && address < pageBufferAddress + pageBufferSize) {
+    FlushPageBuffer();
+  }
+  WaitForCompletion();
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, buffer, size);
+  xSemaphoreGive(mutex);
 }
 
 void SpiNorFlash::WriteEnable() {
@@ -91,14 +111,19 @@ void SpiNorFlash::SectorErase(uint32_t sectorAddress) {
                           static_cast<uint8_t>(sectorAddress >> 8U),
                           static_cast<uint8_t>(sectorAddress)};
 
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  FlushPageBuffer();
+  WaitForCompletion();
+
   WriteEnable();
   while (!WriteEnabled())
     vTaskDelay(1);
 
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, nullptr, 0);
-
-  while (WriteInProgress())
-    vTaskDelay(1);
+  busy = true;
+  programming = false;
+  pendingAddress = sectorAddress;
+  xSemaphoreGive(mutex);
 }
 
 uint8_t SpiNorFlash::ReadSecurityRegister() {
@@ -108,41 +133,108 @@ uint8_t SpiNorFlash::ReadSecurityRegister() {
   return status;
 }
 
-bool SpiNorFlash::ProgramFailed() {
-  return (ReadSecurityRegister() & 0x20u) == 0x20u;
+bool SpiNorFlash::ProgramFailed(uint32_t address, size_t size) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  FlushPageBuffer();
+  WaitForCompletion();
+  bool failed = TakeFailures(programFailures, address, size);
+  xSemaphoreGive(mutex);
+  return failed;
 }
 
-bool SpiNorFlash::EraseFailed() {
-  return (ReadSecurityRegister() & 0x40u) == 0x40u;
+bool SpiNorFlash::EraseFailed(uint32_t address, size_t size) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  WaitForCompletion();
+  bool failed = TakeFailures(eraseFailures, address, size);
+  xSemaphoreGive(mutex);
+  return failed;
+}
+
+bool SpiNorFlash::TakeFailures(std::bitset<nbSectors>& failures, uint32_t address, size_t size) {
+  bool failed = false;
+  for (uint32_t sector = address / sectorSize; sector < nbSectors && sector * sectorSize < address + size; sector++) {
+    failed |= failures[sector];
+    failures[sector] = false;
+  }
+  return failed;
 }
 
 void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
-  static constexpr uint8_t cmdSize = 4;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  while (size > 0) {
+    if (pageBufferSize > 0 && address != pageBufferAddress + pageBufferSize) {
+      FlushPageBuffer();
+    }
+    if (pageBufferSize == 0) {
+      pageBufferAddress = address;
+    }
+
+    uint32_t pageLimit = (pageBufferAddress & ~(pageSize - 1u)) + pageSize;
+    size_t toCopy = std::min<size_t>(pageLimit - address, size);
+    std::memcpy(pageBuffer.data() + pageBufferSize, buffer, toCopy);
+    pageBufferSize += toCopy;
+
+    if (pageBufferAddress + pageBufferSize == pageLimit) {
+      FlushPageBuffer();
+    }
+
+    address += toCopy;
+    buffer += toCopy;
+    size -= toCopy;
+  }
+  xSemaphoreGive(mutex);
+}
 
-  size_t len = size;
-  uint32_t addr = address;
-  const uint8_t* b = buffer;
-  while (len > 0) {
-    uint32_t pageLimit = (addr & ~(pageSize - 1u)) + pageSize;
-    uint32_t toWrite = pageLimit - addr > len ? len : pageLimit - addr;
+void SpiNorFlash::Flush() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  FlushPageBuffer();
+  WaitForCompletion();
+  xSemaphoreGive(mutex);
+}
+
+void SpiNorFlash::FlushPageBuffer() {
+  if (pageBufferSize == 0) {
+    return;
+  }
 
-    uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::PageProgram),
-                            static_cast<uint8_t>(addr >> 16U),
-                            static_cast<uint8_t>(addr >> 8U),
-                            static_cast<uint8_t>(addr)};
+  static constexpr uint8_t cmdSize = 4;
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::PageProgram),
+                          static_cast<uint8_t>(pageBufferAddress >> 16U),
+                          static_cast<uint8_t>(pageBufferAddress >> 8U),
+                          static_cast<uint8_t>(pageBufferAddress)};
+
+  WaitForCompletion();
 
-    WriteEnable();
-    while (!WriteEnabled())
-      vTaskDelay(1);
+  WriteEnable();
+  while (!WriteEnabled())
+    vTaskDelay(1);
 
-    spi.WriteCmdAndBuffer(cmd, cmdSize, b, toWrite);
+  // The transfer is done when WriteCmdAndBuffer() returns, the page buffer can be refilled while the flash programs it
+  spi.WriteCmdAndBuffer(cmd, cmdSize, pageBuffer.data(), pageBufferSize);
+  busy = true;
+  programming = true;
+  pendingAddress = pageBufferAddress;
+  pageBufferSize = 0;
+}
 
-    while (WriteInProgress())
-      vTaskDelay(1);
+void SpiNorFlash::WaitForCompletion() {
+  if (!busy) {
+    return;
+  }
 
-    addr += toWrite;
-    b += toWrite;
-    len -= toWrite;
+  while (WriteInProgress())
+    vTaskDelay(1);
+  busy = false;
+
+  // The security register only reports the result of the last operation: check each of them before starting the next one
+  const uint8_t securityRegister = ReadSecurityRegister();
+  const uint32_t sector = pendingAddress / sectorSize;
+  if (sector < nbSectors) {
+    if (programming && (securityRegister & 0x20u) == 0x20u) {
+      programFailures[sector] = true;
+    } else if (!programming && (securityRegister & 0x40u) == 0x40u) {
+      eraseFailures[sector] = true;
+    }
   }
 }
 
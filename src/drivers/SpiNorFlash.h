@@ -1,6 +1,10 @@
 #pragma once
+#include <array>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
+#include <FreeRTOS.h>
+#include <semphr.h>
 
 namespace Pinetime {
   namespace Drivers {
@@ -8,7 +12,11 @@ namespace Pinetime {
 
     class SpiNorFlash {
     public:
-      explicit SpiNorFlash(Spi& spi);
+      // Read is limited to a lower SPI clock than Fast Read, which costs an extra dummy byte per command. Both are within their
+      // limits at 8MHz, Fast Read is only needed when the flash is clocked faster.
+      enum class ReadModes : uint8_t { Normal, Fast };
+
+      explicit SpiNorFlash(Spi& spi, ReadModes readMode = ReadModes::Normal);
       SpiNorFlash(const SpiNorFlash&) = delete;
       SpiNorFlash& operator=(const SpiNorFlash&) = delete;
       SpiNorFlash(SpiNorFlash&&) = delete;
@@ -25,12 +33,17 @@ namespace Pinetime {
       bool WriteEnabled();
       uint8_t ReadConfigurationRegister();
       void Read(uint32_t address, uint8_t* buffer, size_t size);
+      // Writes are gathered into pages: a page is programmed once it is complete, or when Flush() is called.
+      // Program and erase operations are started and return immediately, the next access waits for their completion.
       void Write(uint32_t address, const uint8_t* buffer, size_t size);
+      void Flush();
       void WriteEnable();
       void SectorErase(uint32_t sectorAddress);
       uint8_t ReadSecurityRegister();
-      bool ProgramFailed();
-      bool EraseFailed();
+      // Return true if a page program (or sector erase) failed in the given range since the last call for this range.
+      // The failures are recorded for each sector, so that each writer (littlefs, DFU) only gets the failures of its own area.
+      bool ProgramFailed(uint32_t address, size_t size);
+      bool EraseFailed(uint32_t address, size_t size);
 
       Identification GetIdentification() const;
 
@@ -42,10 +55,13 @@ namespace Pinetime {
 
     private:
       Identification ReadIdentification();
+      void FlushPageBuffer();
+      void WaitForCompletion();
 
       enum class Commands : uint8_t {
         PageProgram = 0x02,
         Read = 0x03,
+        FastRead = 0x0B,
         ReadStatusRegister = 0x05,
         WriteEnable = 0x06,
         ReadConfigurationRegister = 0x15,
@@ -56,9 +72,27 @@ namespace Pinetime {
         DeepPowerDown = 0xB9
       };
       static constexpr uint16_t pageSize = 256;
+      static constexpr uint32_t sectorSize = 0x1000;
+      // 4MB
+      static constexpr size_t nbSectors = 1024;
+
+      bool TakeFailures(std::bitset<nbSectors>& failures, uint32_t address, size_t size);
 
       Spi& spi;
+      const ReadModes readMode;
       Identification device_id;
+
+      SemaphoreHandle_t mutex = nullptr;
+      std::array<uint8_t, pageSize> pageBuffer;
+      uint32_t pageBufferAddress = 0;
+      size_t pageBufferSize = 0;
+      // A program or erase operation has been started and may not be finished yet
+      bool busy = false;
+      // The pending operation is a page program (or a sector erase), at pendingAddress
+      bool programming = false;
+      uint32_t pendingAddress = 0;
+      std::bitset<nbSectors> programFailures;
+      std::bitset<nbSectors> eraseFailures;
     };
   }
 }
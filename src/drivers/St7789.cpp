@@ -1,4 +1,3 @@
-#include <cstring>
 #include "drivers/St7789.h"
 #include <hal/nrf_gpio.h>
 #include <nrfx_log.h>
@@ -35,28 +34,35 @@ void St7789::Init() {
   DisplayOn();
 }
 
-void St7789::WriteData(uint8_t data) {
-  WriteData(&data, 1);
-}
-
-void St7789::WriteData(const uint8_t* data, size_t size) {
-  WriteSpi(data, size, [pinDataCommand = pinDataCommand]() {
-    nrf_gpio_pin_set(pinDataCommand);
-  });
+void St7789::DataCommandHook(void* instance, bool isData) {
+  auto* lcd = static_cast<St7789*>(instance);
+  if (isData) {
+    nrf_gpio_pin_set(lcd->pinDataCommand);
+  } else {
+    nrf_gpio_pin_clear(lcd->pinDataCommand);
+  }
 }
 
-void St7789::WriteCommand(uint8_t data) {
-  WriteCommand(&data, 1);
+void St7789::WriteCommand(uint8_t cmd) {
+  WriteCommand(cmd, nullptr, 0);
 }
 
-void St7789::WriteCommand(const uint8_t* data, size_t size) {
-  WriteSpi(data, size, [pinDataCommand = pinDataCommand]() {
-    nrf_gpio_pin_clear(pinDataCommand);
-  });
+void St7789::WriteCommand(uint8_t cmd, uint8_t data) {
+  WriteCommand(cmd, &data, 1);
 }
 
-void St7789::WriteSpi(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
-  spi.Write(data, size, preTransactionHook);
+// The command and its parameters are sent in a single SPI transaction, D/C being switched by DataCommandHook()
+void St7789::WriteCommand(uint8_t cmd, const uint8_t* data, size_t size, DrawCompleteCallback onDrawComplete, void* onDrawCompleteContext) {
+  SpiMaster::Transaction transaction;
+  transaction.command[0] = cmd;
+  transaction.commandSize = 1;
+  transaction.txData = data;
+  transaction.txSize = size;
+  transaction.phaseHook = DataCommandHook;
+  transaction.phaseHookContext = this;
+  transaction.onComplete = onDrawComplete;
+  transaction.onCompleteContext = onDrawCompleteContext;
+  spi.Transfer(transaction);
 }
 
 void St7789::SoftwareReset() {
@@ -70,14 +76,13 @@ void St7789::SoftwareReset() {
 }
 
 void St7789::Command2Enable() {
-  WriteCommand(static_cast<uint8_t>(Commands::Command2Enable));
   constexpr uint8_t args[] = {
     0x5a, // Constant
     0x69, // Constant
     0x02, // Constant
     0x01, // Enable
   };
-  WriteData(args, sizeof(args));
+  WriteCommand(static_cast<uint8_t>(Commands::Command2Enable), args, sizeof(args));
 }
 
 void St7789::SleepOut() {
@@ -115,13 +120,11 @@ void St7789::SleepIn() {
 }
 
 void St7789::PixelFormat() {
-  WriteCommand(static_cast<uint8_t>(Commands::PixelFormat));
   // 65K colours, 16-bit per pixel
-  WriteData(0x55);
+  WriteCommand(static_cast<uint8_t>(Commands::PixelFormat), 0x55);
 }
 
 void St7789::MemoryDataAccessControl() {
-  WriteCommand(static_cast<uint8_t>(Commands::MemoryDataAccessControl));
 #ifdef DRIVER_DISPLAY_MIRROR
   // [7] = MY = Page Address Order, 0 = Top to bottom, 1 = Bottom to top
   // [6] = MX = Column Address Order, 0 = Left to right, 1 = Right to left
@@ -130,9 +133,9 @@ void St7789::MemoryDataAccessControl() {
   // [3] = RGB = RGB/BGR Order, 0 = RGB, 1 = BGR
   // [2] = MH = Display Data Latch Order, 0 = LCD refresh from left to right, 1 = Right to left
   // [0 .. 1] = Unused
-  WriteData(0b01000000);
+  WriteCommand(static_cast<uint8_t>(Commands::MemoryDataAccessControl), 0b01000000);
 #else
-  WriteData(0x00);
+  WriteCommand(static_cast<uint8_t>(Commands::MemoryDataAccessControl), 0x00);
 #endif
 }
 
@@ -153,7 +156,6 @@ void St7789::IdleModeOff() {
 }
 
 void St7789::PorchSet() {
-  WriteCommand(static_cast<uint8_t>(Commands::Porch));
   constexpr uint8_t args[] = {
     0x02, // Normal mode front porch
     0x03, // Normal mode back porch
@@ -161,17 +163,15 @@ void St7789::PorchSet() {
     0xed, // Idle mode front:back porch
     0xed, // Partial mode front:back porch (partial mode unused but set anyway)
   };
-  WriteData(args, sizeof(args));
+  WriteCommand(static_cast<uint8_t>(Commands::Porch), args, sizeof(args));
 }
 
 void St7789::FrameRateNormalSet() {
-  WriteCommand(static_cast<uint8_t>(Commands::FrameRateNormal));
   // Note that the datasheet table is imprecise - see formula below table
-  WriteData(0x0a);
+  WriteCommand(static_cast<uint8_t>(Commands::FrameRateNormal), 0x0a);
 }
 
 void St7789::IdleFrameRateOn() {
-  WriteCommand(static_cast<uint8_t>(Commands::FrameRateIdle));
   // According to the datasheet, these controls should apply only to partial/idle mode
   // However they appear to apply to normal mode, so we have to enable/disable
   // every time we enter/exit always on
@@ -180,17 +180,16 @@ void St7789::IdleFrameRateOn() {
     0x1e, // Idle mode frame rate
     0x1e, // Partial mode frame rate (unused)
   };
-  WriteData(args, sizeof(args));
+  WriteCommand(static_cast<uint8_t>(Commands::FrameRateIdle), args, sizeof(args));
 }
 
 void St7789::IdleFrameRateOff() {
-  WriteCommand(static_cast<uint8_t>(Commands::FrameRateIdle));
   constexpr uint8_t args[] = {
     0x00, // Disable frame rate control and divider
     0x0a, // Idle mode frame rate (normal)
     0x0a, // Partial mode frame rate (normal, unused)
   };
-  WriteData(args, sizeof(args));
+  WriteCommand(static_cast<uint8_t>(Commands::FrameRateIdle), args, sizeof(args));
 }
 
 void St7789::DisplayOn() {
@@ -198,55 +197,47 @@ void St7789::DisplayOn() {
 }
 
 void St7789::PowerControl() {
-  WriteCommand(static_cast<uint8_t>(Commands::PowerControl1));
   constexpr uint8_t args[] = {
     0xa4, // Constant
     0x00, // Lowest possible voltages
   };
-  WriteData(args, sizeof(args));
+  WriteCommand(static_cast<uint8_t>(Commands::PowerControl1), args, sizeof(args));
 
-  WriteCommand(static_cast<uint8_t>(Commands::PowerControl2));
   // Lowest possible boost circuit clocks
-  WriteData(0xb3);
+  WriteCommand(static_cast<uint8_t>(Commands::PowerControl2), 0xb3);
 }
 
 void St7789::GateControl() {
-  WriteCommand(static_cast<uint8_t>(Commands::GateControl));
   // Lowest possible VGL/VGH
-  WriteData(0x00);
+  WriteCommand(static_cast<uint8_t>(Commands::GateControl), 0x00);
 }
 
 void St7789::SetAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
-  WriteCommand(static_cast<uint8_t>(Commands::ColumnAddressSet));
   uint8_t colArgs[] = {
     static_cast<uint8_t>(x0 >> 8), // x start MSB
     static_cast<uint8_t>(x0),      // x start LSB
     static_cast<uint8_t>(x1 >> 8), // x end MSB
     static_cast<uint8_t>(x1)       // x end LSB
   };
-  WriteData(colArgs, sizeof(colArgs));
+  WriteCommand(static_cast<uint8_t>(Commands::ColumnAddressSet), colArgs, sizeof(colArgs));
 
-  WriteCommand(static_cast<uint8_t>(Commands::RowAddressSet));
   uint8_t rowArgs[] = {
     static_cast<uint8_t>(y0 >> 8), // y start MSB
     static_cast<uint8_t>(y0),      // y start LSB
     static_cast<uint8_t>(y1 >> 8), // y end MSB
     static_cast<uint8_t>(y1)       // y end LSB
   };
-  memcpy(addrWindowArgs, rowArgs, sizeof(rowArgs));
-  WriteData(addrWindowArgs, sizeof(addrWindowArgs));
+  WriteCommand(static_cast<uint8_t>(Commands::RowAddressSet), rowArgs, sizeof(rowArgs));
 }
 
-void St7789::WriteToRam(const uint8_t* data, size_t size) {
-  WriteCommand(static_cast<uint8_t>(Commands::WriteToRam));
-  WriteData(data, size);
+void St7789::WriteToRam(const uint8_t* data, size_t size, DrawCompleteCallback onDrawComplete, void* onDrawCompleteContext) {
+  WriteCommand(static_cast<uint8_t>(Commands::WriteToRam), data, size, onDrawComplete, onDrawCompleteContext);
 }
 
 void St7789::SetVdv() {
   // By default there is a large step from pixel brightness zero to one.
   // After experimenting with VCOMS, VRH and VDV, this was found to produce good results.
-  WriteCommand(static_cast<uint8_t>(Commands::VdvSet));
-  WriteData(0x10);
+  WriteCommand(static_cast<uint8_t>(Commands::VdvSet), 0x10);
 }
 
 void St7789::DisplayOff() {
@@ -255,21 +246,26 @@ void St7789::DisplayOff() {
 
 void St7789::VerticalScrollStartAddress(uint16_t line) {
   verticalScrollingStartAddress = line;
-  WriteCommand(static_cast<uint8_t>(Commands::VerticalScrollStartAddress));
   uint8_t args[] = {
     static_cast<uint8_t>(line >> 8), // Frame memory line pointer MSB
     static_cast<uint8_t>(line)       // Frame memory line pointer LSB
   };
-  memcpy(verticalScrollArgs, args, sizeof(args));
-  WriteData(verticalScrollArgs, sizeof(verticalScrollArgs));
+  WriteCommand(static_cast<uint8_t>(Commands::VerticalScrollStartAddress), args, sizeof(args));
 }
 
 void St7789::Uninit() {
 }
 
-void St7789::DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size) {
+void St7789::DrawBuffer(uint16_t x,
+                        uint16_t y,
+                        uint16_t width,
+                        uint16_t height,
+                        const uint8_t* data,
+                        size_t size,
+                        DrawCompleteCallback onDrawComplete,
+                        void* onDrawCompleteContext) {
   SetAddrWindow(x, y, x + width - 1, y + height - 1);
-  WriteToRam(data, size);
+  WriteToRam(data, size, onDrawComplete, onDrawCompleteContext);
 }
 
 void St7789::HardwareReset() {
@@ -1,7 +1,6 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
-#include <functional>
 
 #include <FreeRTOS.h>
 
@@ -11,6 +10,9 @@ namespace Pinetime {
 
     class St7789 {
     public:
+      // Invoked from interrupt context once the pixel data of DrawBuffer() has been sent to the display
+      using DrawCompleteCallback = void (*)(void* context);
+
       explicit St7789(Spi& spi, uint8_t pinDataCommand, uint8_t pinReset);
       St7789(const St7789&) = delete;
       St7789& operator=(const St7789&) = delete;
@@ -22,7 +24,14 @@ namespace Pinetime {
 
       void VerticalScrollStartAddress(uint16_t line);
 
-      void DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size);
+      void DrawBuffer(uint16_t x,
+                      uint16_t y,
+                      uint16_t width,
+                      uint16_t height,
+                      const uint8_t* data,
+                      size_t size,
+                      DrawCompleteCallback onDrawComplete = nullptr,
+                      void* onDrawCompleteContext = nullptr);
 
       void LowPowerOn();
       void LowPowerOff();
@@ -47,7 +56,7 @@ namespace Pinetime {
       void MemoryDataAccessControl();
       void DisplayInversionOn();
       void NormalModeOn();
-      void WriteToRam(const uint8_t* data, size_t size);
+      void WriteToRam(const uint8_t* data, size_t size, DrawCompleteCallback onDrawComplete, void* onDrawCompleteContext);
       void IdleModeOn();
       void IdleModeOff();
       void FrameRateNormalSet();
@@ -62,8 +71,13 @@ namespace Pinetime {
       void SetAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
       void SetVdv();
       void WriteCommand(uint8_t cmd);
-      void WriteCommand(const uint8_t* data, size_t size);
-      void WriteSpi(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
+      void WriteCommand(uint8_t cmd, uint8_t data);
+      void WriteCommand(uint8_t cmd,
+                        const uint8_t* data,
+                        size_t size,
+                        DrawCompleteCallback onDrawComplete = nullptr,
+                        void* onDrawCompleteContext = nullptr);
+      static void DataCommandHook(void* instance, bool isData);
 
       enum class Commands : uint8_t {
         SoftwareReset = 0x01,
@@ -91,14 +105,8 @@ namespace Pinetime {
         GateControl = 0xb7,
         Porch = 0xb2,
       };
-      void WriteData(uint8_t data);
-      void WriteData(const uint8_t* data, size_t size);
-
       static constexpr uint16_t Width = 240;
       static constexpr uint16_t Height = 320;
-
-      uint8_t addrWindowArgs[4];
-      uint8_t verticalScrollArgs[2];
     };
   }
 }
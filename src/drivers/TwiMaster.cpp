@@ -2,12 +2,11 @@
 #include <cstring>
 #include <hal/nrf_gpio.h>
 #include <nrfx_log.h>
+#include <task.h>
+#include <algorithm>
 
 using namespace Pinetime::Drivers;
 
-// TODO use shortcut to automatically send STOP when receive LastTX, for example
-// TODO use DMA/IRQ
-
 TwiMaster::TwiMaster(NRF_TWIM_Type* module, uint32_t frequency, uint8_t pinSda, uint8_t pinScl)
   : module {module}, frequency {frequency}, pinSda {pinSda}, pinScl {pinScl} {
 }
@@ -23,8 +22,15 @@ void TwiMaster::ConfigurePins() const {
 }
 
 void TwiMaster::Init() {
-  if (mutex == nullptr) {
-    mutex = xSemaphoreCreateBinary();
+  if (freeSlots == nullptr) {
+    freeSlots = xSemaphoreCreateCounting(queueSize, queueSize);
+    ASSERT(freeSlots != nullptr);
+    freeSynchronousTransactions = xSemaphoreCreateCounting(synchronousTransactions.size(), synchronousTransactions.size());
+    ASSERT(freeSynchronousTransactions != nullptr);
+    for (auto& synchronousTransaction : synchronousTransactions) {
+      synchronousTransaction.done = xSemaphoreCreateBinary();
+      ASSERT(synchronousTransaction.done != nullptr);
+    }
   }
 
   ConfigurePins();
@@ -43,116 +49,218 @@ void TwiMaster::Init() {
   twiBaseAddress->EVENTS_SUSPENDED = 0;
   twiBaseAddress->EVENTS_TXSTARTED = 0;
 
-  twiBaseAddress->ENABLE = (TWIM_ENABLE_ENABLE_Enabled << TWIM_ENABLE_ENABLE_Pos);
+  // The end of a transaction is detected on STOPPED, which always follows LASTRX/LASTTX (shortcuts) or ERROR (OnInterrupt())
+  twiBaseAddress->INTENCLR = 0xFFFFFFFF;
+  twiBaseAddress->INTENSET = TWIM_INTENSET_STOPPED_Msk | TWIM_INTENSET_ERROR_Msk;
 
-  xSemaphoreGive(mutex);
+  // The peripheral is only enabled while transactions are in progress
+  if (!busy) {
+    Sleep();
+  }
+
+  NRFX_IRQ_PRIORITY_SET(nrfx_get_irq_number(twiBaseAddress), 2);
+  NRFX_IRQ_ENABLE(nrfx_get_irq_number(twiBaseAddress));
 }
 
 TwiMaster::ErrorCodes TwiMaster::Read(uint8_t deviceAddress, uint8_t registerAddress, uint8_t* data, size_t size) {
-  xSemaphoreTake(mutex, portMAX_DELAY);
-  Wakeup();
-  auto ret = Write(deviceAddress, &registerAddress, 1, false);
-  ret = Read(deviceAddress, data, size, true);
-  Sleep();
-  xSemaphoreGive(mutex);
-  return ret;
+  Transaction transaction {.deviceAddress = deviceAddress, .registerAddress = registerAddress, .rxData = data, .rxSize = size};
+  return Transfer(transaction);
 }
 
 TwiMaster::ErrorCodes TwiMaster::Write(uint8_t deviceAddress, uint8_t registerAddress, const uint8_t* data, size_t size) {
-  ASSERT(size <= maxDataSize);
-  xSemaphoreTake(mutex, portMAX_DELAY);
-  Wakeup();
-  internalBuffer[0] = registerAddress;
-  std::memcpy(internalBuffer + 1, data, size);
-  auto ret = Write(deviceAddress, internalBuffer, size + 1, true);
-  Sleep();
-  xSemaphoreGive(mutex);
-  return ret;
+  Transaction transaction {.deviceAddress = deviceAddress, .registerAddress = registerAddress, .txData = data, .txSize = size};
+  return Transfer(transaction);
 }
 
-TwiMaster::ErrorCodes TwiMaster::Read(uint8_t deviceAddress, uint8_t* buffer, size_t size, bool stop) {
-  twiBaseAddress->ADDRESS = deviceAddress;
-  twiBaseAddress->TASKS_RESUME = 0x1UL;
-  twiBaseAddress->RXD.PTR = (uint32_t) buffer;
-  twiBaseAddress->RXD.MAXCNT = size;
+TwiMaster::ErrorCodes TwiMaster::Transfer(const Transaction& transaction) {
+  xSemaphoreTake(freeSynchronousTransactions, portMAX_DELAY);
+  taskENTER_CRITICAL();
+  size_t index = 0;
+  while ((usedSynchronousTransactions & (1 << index)) != 0) {
+    index++;
+  }
+  usedSynchronousTransactions |= (1 << index);
+  taskEXIT_CRITICAL();
+
+  auto& synchronousTransaction = synchronousTransactions[index];
+  // Drop a completion left by a previous transaction that was aborted
+  xSemaphoreTake(synchronousTransaction.done, 0);
+  Transaction queued = transaction;
+  queued.onComplete = OnSynchronousTransactionComplete;
+  queued.onCompleteContext = &synchronousTransaction;
+  auto result = ErrorCodes::TransactionFailed;
+  if (Enqueue(queued)) {
+    while (xSemaphoreTake(synchronousTransaction.done, transactionTimeout) != pdTRUE) {
+      AbortFrozenTransaction(&synchronousTransaction);
+    }
+    result = synchronousTransaction.result;
+  }
 
-  twiBaseAddress->TASKS_STARTRX = 1;
+  taskENTER_CRITICAL();
+  usedSynchronousTransactions &= ~(1 << index);
+  taskEXIT_CRITICAL();
+  xSemaphoreGive(freeSynchronousTransactions);
+  return result;
+}
 
-  while (!twiBaseAddress->EVENTS_RXSTARTED && !twiBaseAddress->EVENTS_ERROR)
-    ;
-  twiBaseAddress->EVENTS_RXSTARTED = 0x0UL;
+void TwiMaster::OnSynchronousTransactionComplete(void* context, ErrorCodes result) {
+  auto* synchronousTransaction = static_cast<SynchronousTransaction*>(context);
+  synchronousTransaction->result = result;
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(synchronousTransaction->done, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
 
-  txStartedCycleCount = DWT->CYCCNT;
-  uint32_t currentCycleCount;
-  while (!twiBaseAddress->EVENTS_LASTRX && !twiBaseAddress->EVENTS_ERROR) {
-    currentCycleCount = DWT->CYCCNT;
-    if ((currentCycleCount - txStartedCycleCount) > HwFreezedDelay) {
-      FixHwFreezed();
-      return ErrorCodes::TransactionFailed;
-    }
+bool TwiMaster::Enqueue(const Transaction& transaction) {
+  bool isRead = transaction.rxData != nullptr;
+  if ((isRead && (transaction.rxSize == 0 || transaction.rxSize > TWIM_RXD_MAXCNT_MAXCNT_Msk)) ||
+      (!isRead && transaction.txSize > maxDataSize)) {
+    ASSERT(false);
+    return false;
   }
-  twiBaseAddress->EVENTS_LASTRX = 0x0UL;
 
-  if (stop || twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->TASKS_STOP = 0x1UL;
-    while (!twiBaseAddress->EVENTS_STOPPED)
-      ;
-    twiBaseAddress->EVENTS_STOPPED = 0x0UL;
+  auto ok = xSemaphoreTake(freeSlots, portMAX_DELAY);
+  ASSERT(ok == pdTRUE);
+
+  taskENTER_CRITICAL();
+  auto& queued = queue[(queueHead + queueCount) % queueSize];
+  queued.deviceAddress = transaction.deviceAddress;
+  queued.txBuffer[0] = transaction.registerAddress;
+  if (isRead) {
+    queued.txSize = registerSize;
+    queued.rxData = transaction.rxData;
+    queued.rxSize = transaction.rxSize;
   } else {
-    twiBaseAddress->TASKS_SUSPEND = 0x1UL;
-    while (!twiBaseAddress->EVENTS_SUSPENDED)
-      ;
-    twiBaseAddress->EVENTS_SUSPENDED = 0x0UL;
+    std::memcpy(queued.txBuffer.data() + registerSize, transaction.txData, transaction.txSize);
+    queued.txSize = registerSize + transaction.txSize;
+    queued.rxData = nullptr;
+    queued.rxSize = 0;
+  }
+  queued.onComplete = transaction.onComplete;
+  queued.onCompleteContext = transaction.onCompleteContext;
+  queued.enqueuedAt = xTaskGetTickCount();
+  queued.statistics = FindStatistics(transaction.deviceAddress);
+  queueCount++;
+  if (!busy) {
+    StartNextTransaction();
   }
+  taskEXIT_CRITICAL();
 
-  if (twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->EVENTS_ERROR = 0x0UL;
+  return true;
+}
+
+// Must be called from a critical section
+TwiMaster::DeviceStatistics* TwiMaster::FindStatistics(uint8_t deviceAddress) {
+  for (size_t i = 0; i < nbDevices; i++) {
+    if (devices[i].deviceAddress == deviceAddress) {
+      return &devices[i];
+    }
   }
-  return ErrorCodes::NoError;
+  if (nbDevices == maxDevices) {
+    return nullptr;
+  }
+  devices[nbDevices] = {};
+  devices[nbDevices].deviceAddress = deviceAddress;
+  return &devices[nbDevices++];
 }
 
-TwiMaster::ErrorCodes TwiMaster::Write(uint8_t deviceAddress, const uint8_t* data, size_t size, bool stop) {
-  twiBaseAddress->ADDRESS = deviceAddress;
-  twiBaseAddress->TASKS_RESUME = 0x1UL;
-  twiBaseAddress->TXD.PTR = (uint32_t) data;
-  twiBaseAddress->TXD.MAXCNT = size;
+size_t TwiMaster::GetStatistics(DeviceStatistics* statistics, size_t maxStatistics) const {
+  taskENTER_CRITICAL();
+  size_t count = std::min(nbDevices, maxStatistics);
+  std::copy(devices.begin(), devices.begin() + count, statistics);
+  taskEXIT_CRITICAL();
+  return count;
+}
 
+// Must be called with the TWI interrupt masked (critical section or TWI interrupt itself)
+void TwiMaster::StartNextTransaction() {
+  if (queueCount == 0) {
+    busy = false;
+    Sleep();
+    return;
+  }
+
+  current = queue[queueHead];
+  queueHead = (queueHead + 1) % queueSize;
+  queueCount--;
+  busy = true;
+  transactionFailed = false;
+  current.startedAt = xTaskGetTickCountFromISR();
+
+  Wakeup();
+  twiBaseAddress->ADDRESS = current.deviceAddress;
+  twiBaseAddress->TXD.PTR = reinterpret_cast<uint32_t>(current.txBuffer.data());
+  twiBaseAddress->TXD.MAXCNT = current.txSize;
+  if (current.rxData != nullptr) {
+    // The register address is followed by a repeated start and the read, then STOP, without any CPU intervention
+    twiBaseAddress->RXD.PTR = reinterpret_cast<uint32_t>(current.rxData);
+    twiBaseAddress->RXD.MAXCNT = current.rxSize;
+    twiBaseAddress->SHORTS = TWIM_SHORTS_LASTTX_STARTRX_Msk | TWIM_SHORTS_LASTRX_STOP_Msk;
+  } else {
+    twiBaseAddress->SHORTS = TWIM_SHORTS_LASTTX_STOP_Msk;
+  }
   twiBaseAddress->TASKS_STARTTX = 1;
+}
 
-  while (!twiBaseAddress->EVENTS_TXSTARTED && !twiBaseAddress->EVENTS_ERROR)
-    ;
-  twiBaseAddress->EVENTS_TXSTARTED = 0x0UL;
-
-  txStartedCycleCount = DWT->CYCCNT;
-  uint32_t currentCycleCount;
-  while (!twiBaseAddress->EVENTS_LASTTX && !twiBaseAddress->EVENTS_ERROR) {
-    currentCycleCount = DWT->CYCCNT;
-    if ((currentCycleCount - txStartedCycleCount) > HwFreezedDelay) {
-      FixHwFreezed();
-      return ErrorCodes::TransactionFailed;
+// Must be called with the TWI interrupt masked (critical section or TWI interrupt itself)
+void TwiMaster::CompleteTransaction(ErrorCodes result, BaseType_t* xHigherPriorityTaskWoken) {
+  auto* statistics = current.statistics;
+  if (statistics != nullptr) {
+    uint32_t latency = xTaskGetTickCountFromISR() - current.enqueuedAt;
+    statistics->transactions++;
+    if (result != ErrorCodes::NoError) {
+      statistics->errors++;
     }
+    statistics->totalLatency += latency;
+    statistics->maxLatency = std::max(statistics->maxLatency, latency);
   }
-  twiBaseAddress->EVENTS_LASTTX = 0x0UL;
 
-  if (stop || twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->TASKS_STOP = 0x1UL;
-    while (!twiBaseAddress->EVENTS_STOPPED)
-      ;
-    twiBaseAddress->EVENTS_STOPPED = 0x0UL;
-  } else {
-    twiBaseAddress->TASKS_SUSPEND = 0x1UL;
-    while (!twiBaseAddress->EVENTS_SUSPENDED)
-      ;
-    twiBaseAddress->EVENTS_SUSPENDED = 0x0UL;
+  auto onComplete = current.onComplete;
+  auto* onCompleteContext = current.onCompleteContext;
+  StartNextTransaction();
+  xSemaphoreGiveFromISR(freeSlots, xHigherPriorityTaskWoken);
+
+  if (onComplete != nullptr) {
+    onComplete(onCompleteContext, result);
   }
+}
 
-  if (twiBaseAddress->EVENTS_ERROR) {
-    twiBaseAddress->EVENTS_ERROR = 0x0UL;
+void TwiMaster::OnInterrupt() {
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+  if (twiBaseAddress->EVENTS_ERROR == 1) {
+    twiBaseAddress->EVENTS_ERROR = 0;
     uint32_t error = twiBaseAddress->ERRORSRC;
     twiBaseAddress->ERRORSRC = error;
+    transactionFailed = true;
+    // The shortcuts don't stop the transaction on NACK, STOPPED will end it
+    twiBaseAddress->SHORTS = 0;
+    twiBaseAddress->TASKS_RESUME = 1;
+    twiBaseAddress->TASKS_STOP = 1;
   }
 
-  return ErrorCodes::NoError;
+  if (twiBaseAddress->EVENTS_STOPPED == 1) {
+    twiBaseAddress->EVENTS_STOPPED = 0;
+    if (busy) {
+      CompleteTransaction(transactionFailed ? ErrorCodes::TransactionFailed : ErrorCodes::NoError, &xHigherPriorityTaskWoken);
+    }
+  }
+
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+// Aborts the transaction in progress if it has been running for longer than transactionTimeout, and if it's the transaction
+// of the caller (onCompleteContext) or an asynchronous one, that nobody else waits for. The synchronous transactions of
+// the other tasks are left to their own task, which measures their timeout.
+void TwiMaster::AbortFrozenTransaction(const void* onCompleteContext) {
+  taskENTER_CRITICAL();
+  bool waitedByOtherTask = current.onComplete == OnSynchronousTransactionComplete && current.onCompleteContext != onCompleteContext;
+  if (busy && !waitedByOtherTask && xTaskGetTickCount() - current.startedAt >= transactionTimeout) {
+    FixHwFreezed();
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    CompleteTransaction(ErrorCodes::TransactionFailed, &xHigherPriorityTaskWoken);
+  }
+  taskEXIT_CRITICAL();
 }
 
 void TwiMaster::Sleep() {
@@ -171,9 +279,9 @@ void TwiMaster::Wakeup() {
 void TwiMaster::FixHwFreezed() {
   NRF_LOG_INFO("I2C device frozen, reinitializing it!");
 
-  uint32_t twi_state = NRF_TWI1->ENABLE;
-
   Sleep();
 
-  twiBaseAddress->ENABLE = twi_state;
+  twiBaseAddress->SHORTS = 0;
+  twiBaseAddress->EVENTS_STOPPED = 0;
+  twiBaseAddress->EVENTS_ERROR = 0;
 }
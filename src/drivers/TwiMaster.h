@@ -2,6 +2,8 @@
 #include <FreeRTOS.h>
 #include <semphr.h>
 #include <drivers/include/nrfx_twi.h> // NRF_TWIM_Type
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace Pinetime {
@@ -10,32 +12,110 @@ namespace Pinetime {
     public:
       enum class ErrorCodes { NoError, TransactionFailed };
 
+      static constexpr uint8_t maxDataSize {16};
+      static constexpr uint8_t registerSize {1};
+
+      // Called from the TWI interrupt once the transaction is complete (STOP sent)
+      using TransactionCallback = void (*)(void* context, ErrorCodes result);
+
+      // Reads rxSize bytes from registerAddress (repeated start after the register address),
+      // or writes txSize bytes from txData at registerAddress when rxData is nullptr.
+      struct Transaction {
+        uint8_t deviceAddress;
+        uint8_t registerAddress;
+        uint8_t* rxData = nullptr;
+        size_t rxSize = 0;
+        const uint8_t* txData = nullptr;
+        size_t txSize = 0;
+        TransactionCallback onComplete = nullptr;
+        void* onCompleteContext = nullptr;
+      };
+
+      struct DeviceStatistics {
+        uint8_t deviceAddress;
+        uint32_t transactions;
+        uint32_t errors;
+        // From Enqueue() to the end of the transaction, in ticks
+        uint32_t totalLatency;
+        uint32_t maxLatency;
+      };
+
+      static constexpr size_t maxDevices = 4;
+
       TwiMaster(NRF_TWIM_Type* module, uint32_t frequency, uint8_t pinSda, uint8_t pinScl);
 
       void Init();
+
+      // Enqueue the transaction and block the calling task until it's complete
       ErrorCodes Read(uint8_t deviceAddress, uint8_t registerAddress, uint8_t* buffer, size_t size);
       ErrorCodes Write(uint8_t deviceAddress, uint8_t registerAddress, const uint8_t* data, size_t size);
 
+      // Queues the transaction and returns immediately. The data to write is copied, the receive buffer must stay valid until
+      // onComplete is called. Blocks only if the queue is full.
+      bool Enqueue(const Transaction& transaction);
+
+      void OnInterrupt();
+
+      // Statistics of the devices addressed since boot, in the order of their first transaction. Returns how many were copied.
+      size_t GetStatistics(DeviceStatistics* statistics, size_t maxStatistics) const;
+
       void Sleep();
       void Wakeup();
 
     private:
-      ErrorCodes Read(uint8_t deviceAddress, uint8_t* buffer, size_t size, bool stop);
-      ErrorCodes Write(uint8_t deviceAddress, const uint8_t* data, size_t size, bool stop);
+      struct QueuedTransaction {
+        uint8_t deviceAddress;
+        // Register address followed by the data to write
+        std::array<uint8_t, registerSize + maxDataSize> txBuffer;
+        uint8_t txSize;
+        uint8_t* rxData;
+        uint8_t rxSize;
+        TransactionCallback onComplete;
+        void* onCompleteContext;
+        TickType_t enqueuedAt;
+        TickType_t startedAt;
+        DeviceStatistics* statistics;
+      };
+
+      static constexpr size_t queueSize = 4;
+      // Measured from the start of the transaction, the peripheral is considered frozen after that
+      static constexpr TickType_t transactionTimeout = pdMS_TO_TICKS(20);
+
+      ErrorCodes Transfer(const Transaction& transaction);
+      static void OnSynchronousTransactionComplete(void* context, ErrorCodes result);
+      DeviceStatistics* FindStatistics(uint8_t deviceAddress);
+      void StartNextTransaction();
+      void CompleteTransaction(ErrorCodes result, BaseType_t* xHigherPriorityTaskWoken);
+      void AbortFrozenTransaction(const void* onCompleteContext);
       void FixHwFreezed();
       void ConfigurePins() const;
 
       NRF_TWIM_Type* twiBaseAddress;
-      SemaphoreHandle_t mutex = nullptr;
       NRF_TWIM_Type* module;
       uint32_t frequency;
       uint8_t pinSda;
       uint8_t pinScl;
-      static constexpr uint8_t maxDataSize {16};
-      static constexpr uint8_t registerSize {1};
-      uint8_t internalBuffer[maxDataSize + registerSize];
-      uint32_t txStartedCycleCount = 0;
-      static constexpr uint32_t HwFreezedDelay {161000};
+
+      std::array<QueuedTransaction, queueSize> queue;
+      size_t queueHead = 0;
+      size_t queueCount = 0;
+      SemaphoreHandle_t freeSlots = nullptr;
+      QueuedTransaction current;
+      volatile bool busy = false;
+      bool transactionFailed = false;
+
+      // Completion of the transactions started by Read() and Write(), up to one per queue slot
+      struct SynchronousTransaction {
+        SemaphoreHandle_t done = nullptr;
+        ErrorCodes result;
+      };
+
+      std::array<SynchronousTransaction, queueSize> synchronousTransactions;
+      SemaphoreHandle_t freeSynchronousTransactions = nullptr;
+      uint8_t usedSynchronousTransactions = 0;
+
+      std::array<DeviceStatistics, maxDevices> devices {};
+      size_t nbDevices = 0;
     };
   }
 }
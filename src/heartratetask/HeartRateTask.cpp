@@ -1,12 +1,17 @@
 #include "heartratetask/HeartRateTask.h"
 #include <drivers/Hrs3300.h>
 #include <components/heartrate/HeartRateController.h>
+#include <components/motion/MotionController.h>
+#include <cstdlib>
 #include <nrf_log.h>
 
 using namespace Pinetime::Applications;
 
-HeartRateTask::HeartRateTask(Drivers::Hrs3300& heartRateSensor, Controllers::HeartRateController& controller)
-  : heartRateSensor {heartRateSensor}, controller {controller} {
+HeartRateTask::HeartRateTask(Drivers::Hrs3300& heartRateSensor,
+                             Controllers::HeartRateController& controller,
+                             const Controllers::MotionController& motionController,
+                             Controllers::FS& fs)
+  : heartRateSensor {heartRateSensor}, controller {controller}, motionController {motionController}, replay {fs} {
 }
 
 void HeartRateTask::Start() {
@@ -30,7 +35,7 @@ void HeartRateTask::Work() {
     uint32_t delay;
     if (state == States::Running) {
       if (measurementStarted) {
-        delay = ppg.deltaTms;
+        delay = paused ? pausePollPeriod : ppg.deltaTms;
       } else {
         delay = 100;
       }
@@ -70,9 +75,22 @@ void HeartRateTask::Work() {
     }
 
     if (measurementStarted) {
-      auto sensorData = heartRateSensor.ReadHrsAls();
+      if (paused) {
+        if (MustResume()) {
+          Resume();
+        }
+        continue;
+      }
+
+      Drivers::Hrs3300::PackedHrsAls sensorData;
+      if (!ReadSample(sensorData)) {
+        continue;
+      }
+      replay.BeginProcessing();
       int8_t ambient = ppg.Preprocess(sensorData.hrs, sensorData.als);
       int bpm = ppg.HeartRate();
+      replay.EndProcessing(bpm);
+      CheckStability(bpm, lastBpm, ambient > 0);
 
       // If ambient light detected or a reset requested (bpm < 0)
       if (ambient > 0) {
@@ -97,6 +115,10 @@ void HeartRateTask::Work() {
         lastBpm = bpm;
         controller.Update(Controllers::HeartRateController::States::Running, lastBpm);
       }
+
+      if (nbStableReadings >= stableReadingsBeforePause && !replay.IsRunning()) {
+        Pause();
+      }
     }
   }
 }
@@ -108,13 +130,70 @@ void HeartRateTask::PushMessage(HeartRateTask::Messages msg) {
 }
 
 void HeartRateTask::StartMeasurement() {
-  heartRateSensor.Enable();
+  paused = false;
+  nbStableReadings = 0;
+  if (!replay.Start()) {
+    heartRateSensor.Enable();
+  }
   ppg.Reset(true);
   vTaskDelay(100);
 }
 
 void HeartRateTask::StopMeasurement() {
-  heartRateSensor.Disable();
+  paused = false;
+  if (replay.IsRunning()) {
+    replay.Stop();
+  } else {
+    heartRateSensor.Disable();
+  }
   ppg.Reset(true);
   vTaskDelay(100);
 }
+
+bool HeartRateTask::ReadSample(Drivers::Hrs3300::PackedHrsAls& sample) {
+  if (!replay.IsRunning()) {
+    sample = heartRateSensor.ReadHrsAls();
+    return true;
+  }
+  if (replay.Read(sample)) {
+    return true;
+  }
+
+  // End of the recording: report the statistics and continue with the sensor
+  replay.Stop();
+  heartRateSensor.Enable();
+  ppg.Reset(true);
+  return false;
+}
+
+void HeartRateTask::CheckStability(int bpm, int lastBpm, bool ambientLight) {
+  if (ambientLight || bpm < 0) {
+    nbStableReadings = 0;
+    return;
+  }
+  if (bpm == 0) {
+    // No new reading
+    return;
+  }
+  bool stable = lastBpm > 0 && std::abs(bpm - lastBpm) <= stableBpmDelta && ppg.SignalToNoiseRatio() >= stableSignalToNoise;
+  nbStableReadings = stable ? nbStableReadings + 1 : 0;
+}
+
+void HeartRateTask::Pause() {
+  heartRateSensor.Disable();
+  paused = true;
+  pauseStart = xTaskGetTickCount();
+  stepsAtPause = motionController.NbSteps();
+  nbStableReadings = 0;
+}
+
+void HeartRateTask::Resume() {
+  heartRateSensor.Enable();
+  paused = false;
+  // The samples acquired before the pause are not contiguous with the new ones
+  ppg.Reset(true);
+}
+
+bool HeartRateTask::MustResume() const {
+  return (xTaskGetTickCount() - pauseStart) >= burstPause || motionController.NbSteps() != stepsAtPause;
+}
@@ -3,6 +3,7 @@
 #include <task.h>
 #include <queue.h>
 #include <components/heartrate/Ppg.h>
+#include "heartratetask/PpgReplay.h"
 
 namespace Pinetime {
   namespace Drivers {
@@ -11,6 +12,7 @@ namespace Pinetime {
 
   namespace Controllers {
     class HeartRateController;
+    class MotionController;
   }
 
   namespace Applications {
@@ -19,7 +21,10 @@ namespace Pinetime {
       enum class Messages : uint8_t { GoToSleep, WakeUp, StartMeasurement, StopMeasurement };
       enum class States { Idle, Running };
 
-      explicit HeartRateTask(Drivers::Hrs3300& heartRateSensor, Controllers::HeartRateController& controller);
+      HeartRateTask(Drivers::Hrs3300& heartRateSensor,
+                    Controllers::HeartRateController& controller,
+                    const Controllers::MotionController& motionController,
+                    Controllers::FS& fs);
       void Start();
       void Work();
       void PushMessage(Messages msg);
@@ -28,14 +33,39 @@ namespace Pinetime {
       static void Process(void* instance);
       void StartMeasurement();
       void StopMeasurement();
+      bool ReadSample(Drivers::Hrs3300::PackedHrsAls& sample);
+
+      void CheckStability(int bpm, int lastBpm, bool ambientLight);
+      void Pause();
+      void Resume();
+      bool MustResume() const;
+
+      // Adaptive sampling: once the heart rate is stable and the signal clean, the sensor (and its LED) is switched off
+      // and the measurement continues with short bursts. It goes back to continuous sampling as soon as the signal degrades.
+      // Number of consecutive stable readings (one every 500ms) before pausing
+      static constexpr uint8_t stableReadingsBeforePause = 10;
+      // Maximum difference (BPM) between 2 readings for them to be considered stable
+      static constexpr int stableBpmDelta = 3;
+      // Minimum signal to noise ratio reported by Ppg for the readings to be considered stable
+      static constexpr float stableSignalToNoise = 5.0f;
+      // The burst restarts after this period, or as soon as a step is detected
+      static constexpr TickType_t burstPause = pdMS_TO_TICKS(30 * 1000);
+      static constexpr TickType_t pausePollPeriod = pdMS_TO_TICKS(1000);
 
       TaskHandle_t taskHandle;
       QueueHandle_t messageQueue;
       States state = States::Running;
       Drivers::Hrs3300& heartRateSensor;
       Controllers::HeartRateController& controller;
+      const Controllers::MotionController& motionController;
       Controllers::Ppg ppg;
+      PpgReplay replay;
       bool measurementStarted = false;
+
+      bool paused = false;
+      TickType_t pauseStart = 0;
+      uint32_t stepsAtPause = 0;
+      uint8_t nbStableReadings = 0;
     };
 
   }
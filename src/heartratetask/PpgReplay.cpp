@@ -0,0 +1,84 @@
+#include "heartratetask/PpgReplay.h"
+#include <algorithm>
+#include <nrf.h>
+#include <nrf_log.h>
+#include "components/heartrate/Ppg.h"
+
+using namespace Pinetime::Applications;
+
+PpgReplay::PpgReplay(Controllers::FS& fs) : fs {fs} {
+}
+
+bool PpgReplay::Start() {
+#ifndef PPG_REPLAY
+  return false;
+#else
+  if (running) {
+    Stop();
+  }
+  if (fs.FileOpen(&file, recordingPath, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+
+  // The cycle counter only runs while the CPU is awake, so it measures the processing time of each sample
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  statistics = {};
+  running = true;
+  NRF_LOG_INFO("[PpgReplay] Replaying %s", recordingPath);
+  return true;
+#endif
+}
+
+void PpgReplay::Stop() {
+  if (!running) {
+    return;
+  }
+  fs.FileClose(&file);
+  running = false;
+
+  NRF_LOG_INFO("[PpgReplay] %d samples, %d readings, average %d BPM",
+               statistics.nbSamples,
+               statistics.nbReadings,
+               (statistics.nbReadings > 0) ? statistics.bpmSum / statistics.nbReadings : 0);
+  NRF_LOG_INFO("[PpgReplay] First reading after %d ms",
+               (statistics.firstReadingSample != UINT32_MAX) ? (statistics.firstReadingSample + 1) * Controllers::Ppg::deltaTms : 0);
+  NRF_LOG_INFO("[PpgReplay] %d cycles per sample on average, %d max",
+               (statistics.nbSamples > 0) ? statistics.totalCycles / statistics.nbSamples : 0,
+               statistics.maxCycles);
+}
+
+bool PpgReplay::Read(Drivers::Hrs3300::PackedHrsAls& sample) {
+  if (!running) {
+    return false;
+  }
+  return fs.FileRead(&file, reinterpret_cast<uint8_t*>(&sample), sizeof(sample)) == sizeof(sample);
+}
+
+void PpgReplay::BeginProcessing() {
+  if (!running) {
+    return;
+  }
+  processingStart = DWT->CYCCNT;
+}
+
+void PpgReplay::EndProcessing(int bpm) {
+  if (!running) {
+    return;
+  }
+  uint32_t cycles = DWT->CYCCNT - processingStart;
+  statistics.totalCycles += cycles;
+  statistics.maxCycles = std::max(statistics.maxCycles, cycles);
+
+  if (bpm > 0) {
+    // Each reading is logged with the index of its sample, to compute the BPM error against the reference of the recording
+    NRF_LOG_INFO("[PpgReplay] Sample %d : %d BPM", statistics.nbSamples, bpm);
+    if (statistics.firstReadingSample == UINT32_MAX) {
+      statistics.firstReadingSample = statistics.nbSamples;
+    }
+    statistics.nbReadings++;
+    statistics.bpmSum += bpm;
+  }
+  statistics.nbSamples++;
+}
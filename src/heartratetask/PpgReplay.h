@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include "components/fs/FS.h"
+#include "drivers/Hrs3300.h"
+
+namespace Pinetime {
+  namespace Applications {
+    // Feeds the heart rate algorithm with a recording instead of the HRS3300, to tune it with known signals.
+    // The recording is a binary file made of consecutive Hrs3300::PackedHrsAls samples, one every Ppg::deltaTms,
+    // uploaded to the path below. When it exists, it is replayed each time a measurement is started.
+    // Only enabled in the firmwares built with -DPPG_REPLAY=1, the others always use the sensor.
+    class PpgReplay {
+    public:
+      static constexpr const char* recordingPath = "/.system/ppg_replay.bin";
+
+      struct Statistics {
+        uint32_t nbSamples = 0;
+        // Index of the sample that produced the first heart rate value, UINT32_MAX if none was found
+        uint32_t firstReadingSample = UINT32_MAX;
+        uint32_t nbReadings = 0;
+        uint32_t bpmSum = 0;
+        // CPU cycles spent in the heart rate algorithm
+        uint32_t totalCycles = 0;
+        uint32_t maxCycles = 0;
+      };
+
+      explicit PpgReplay(Controllers::FS& fs);
+
+      // Returns false if there is no recording to replay, or if the replay isn't enabled in this build
+      bool Start();
+      void Stop();
+
+      bool IsRunning() const {
+        return running;
+      }
+
+      // Returns false at the end of the recording
+      bool Read(Drivers::Hrs3300::PackedHrsAls& sample);
+
+      // Starts and stops the measurement of the CPU cycles spent on the current sample
+      void BeginProcessing();
+      void EndProcessing(int bpm);
+
+      const Statistics& GetStatistics() const {
+        return statistics;
+      }
+
+    private:
+      Controllers::FS& fs;
+      lfs_file_t file;
+      bool running = false;
+      uint32_t processingStart = 0;
+      Statistics statistics;
+    };
+  }
+}
@@ -67,7 +67,7 @@ Pinetime::Drivers::SpiMaster spi {Pinetime::Drivers::SpiMaster::SpiModule::SPI0,
                                    Pinetime::PinMap::SpiMosi,
                                    Pinetime::PinMap::SpiMiso}};
 
-Pinetime::Drivers::Spi lcdSpi {spi, Pinetime::PinMap::SpiLcdCsn};
+Pinetime::Drivers::Spi lcdSpi {spi, Pinetime::PinMap::SpiLcdCsn, Pinetime::Drivers::SpiMaster::Priorities::High};
 Pinetime::Drivers::St7789 lcd {lcdSpi, Pinetime::PinMap::LcdDataCommand, Pinetime::PinMap::LcdReset};
 
 Pinetime::Drivers::Spi flashSpi {spi, Pinetime::PinMap::SpiFlashCsn};
@@ -93,17 +93,18 @@ TimerHandle_t debounceChargeTimer;
 Pinetime::Controllers::Battery batteryController;
 Pinetime::Controllers::Ble bleController;
 
+Pinetime::Controllers::FS fs {spiNorFlash};
+Pinetime::Controllers::MotionController motionController;
+
 Pinetime::Controllers::HeartRateController heartRateController;
-Pinetime::Applications::HeartRateTask heartRateApp(heartRateSensor, heartRateController);
+Pinetime::Applications::HeartRateTask heartRateApp(heartRateSensor, heartRateController, motionController, fs);
 
-Pinetime::Controllers::FS fs {spiNorFlash};
 Pinetime::Controllers::Settings settingsController {fs};
 Pinetime::Controllers::MotorController motorController {};
 
 Pinetime::Controllers::DateTime dateTimeController {settingsController};
 Pinetime::Drivers::Watchdog watchdog;
 Pinetime::Controllers::NotificationManager notificationManager;
-Pinetime::Controllers::MotionController motionController;
 Pinetime::Controllers::AlarmController alarmController {dateTimeController, fs};
 Pinetime::Controllers::TouchHandler touchHandler;
 Pinetime::Controllers::ButtonHandler buttonHandler;
@@ -167,11 +168,17 @@ uint32_t NoInit_MagicWord __attribute__((section(".noinit")));
 std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> NoInit_BackUpTime __attribute__((section(".noinit")));
 
 void nrfx_gpiote_evt_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action) {
+  Pinetime::System::SystemMonitor::CountInterrupt(Pinetime::System::SystemMonitor::Interrupts::Gpiote);
   if (pin == Pinetime::PinMap::Cst816sIrq) {
     systemTask.PushMessage(Pinetime::System::Messages::OnTouchEvent);
     return;
   }
 
+  if (pin == Pinetime::PinMap::Bma421Irq) {
+    systemTask.PushMessage(Pinetime::System::Messages::OnMotionEvent);
+    return;
+  }
+
   BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
   if (pin == Pinetime::PinMap::PowerPresent and action == NRF_GPIOTE_POLARITY_TOGGLE) {
@@ -193,6 +200,7 @@ void DebounceTimerCallback(TimerHandle_t /*unused*/) {
 }
 
 void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
+  Pinetime::System::SystemMonitor::CountInterrupt(Pinetime::System::SystemMonitor::Interrupts::Spi);
   if (((NRF_SPIM0->INTENSET & (1 << 6)) != 0) && NRF_SPIM0->EVENTS_END == 1) {
     NRF_SPIM0->EVENTS_END = 0;
     spi.OnEndEvent();
@@ -208,6 +216,22 @@ void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
   }
 }
 
+void SPIM1_SPIS1_TWIM1_TWIS1_SPI1_TWI1_IRQHandler(void) {
+  Pinetime::System::SystemMonitor::CountInterrupt(Pinetime::System::SystemMonitor::Interrupts::Twi);
+  twiMaster.OnInterrupt();
+}
+
+// TIMER2 counts the chunks of SPI EasyDMA list transfers and signals their completion
+extern "C" {
+void TIMER2_IRQHandler(void) {
+  Pinetime::System::SystemMonitor::CountInterrupt(Pinetime::System::SystemMonitor::Interrupts::Spi);
+  if (NRF_TIMER2->EVENTS_COMPARE[1] == 1) {
+    NRF_TIMER2->EVENTS_COMPARE[1] = 0;
+    spi.OnEndEvent();
+  }
+}
+}
+
 static void (*radio_isr_addr)();
 static void (*rng_isr_addr)();
 static void (*rtc0_isr_addr)();
@@ -215,6 +239,7 @@ static void (*rtc0_isr_addr)();
 /* Some interrupt handlers required for NimBLE radio driver */
 extern "C" {
 void RADIO_IRQHandler(void) {
+  Pinetime::System::SystemMonitor::CountInterrupt(Pinetime::System::SystemMonitor::Interrupts::Radio);
   ((void (*)()) radio_isr_addr)();
 }
 
@@ -44,7 +44,7 @@ Pinetime::Drivers::SpiMaster spi {Pinetime::Drivers::SpiMaster::SpiModule::SPI0,
 Pinetime::Drivers::Spi flashSpi {spi, Pinetime::PinMap::SpiFlashCsn};
 Pinetime::Drivers::SpiNorFlash spiNorFlash {flashSpi};
 
-Pinetime::Drivers::Spi lcdSpi {spi, Pinetime::PinMap::SpiLcdCsn};
+Pinetime::Drivers::Spi lcdSpi {spi, Pinetime::PinMap::SpiLcdCsn, Pinetime::Drivers::SpiMaster::Priorities::High};
 Pinetime::Drivers::St7789 lcd {lcdSpi, Pinetime::PinMap::LcdDataCommand, Pinetime::PinMap::LcdReset};
 
 Pinetime::Controllers::BrightnessController brightnessController;
@@ -72,6 +72,14 @@ void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
     NRF_SPIM0->EVENTS_STOPPED = 0;
   }
 }
+
+// TIMER2 counts the chunks of SPI EasyDMA list transfers and signals their completion
+void TIMER2_IRQHandler(void) {
+  if (NRF_TIMER2->EVENTS_COMPARE[1] == 1) {
+    NRF_TIMER2->EVENTS_COMPARE[1] = 0;
+    spi.OnEndEvent();
+  }
+}
 }
 
 void RefreshWatchdog() {
@@ -109,6 +117,7 @@ void Process(void* /*instance*/) {
     DisplayProgressBar((static_cast<float>(offset) / static_cast<float>(sizeof(recoveryImage))) * 100.0f, colorWhite);
     RefreshWatchdog();
   }
+  spiNorFlash.Flush();
   NRF_LOG_INFO("Writing factory image done!");
   DisplayProgressBar(100.0f, colorGreen);
 
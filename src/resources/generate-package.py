@@ -10,11 +10,19 @@ import argparse
 import subprocess
 from zipfile import ZipFile
 
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'tools'))
+from resource_pack import build_pack
+
+# Path of the resource pack in the watch FS, see ResourcePack::path
+PACK_FILENAME = 'resources.pak'
+PACK_PATH = '/' + PACK_FILENAME
+
 def main():
     ap = argparse.ArgumentParser(description='auto generate LVGL font files from fonts')
     ap.add_argument('--config', '-c', type=str, action='append', help='config file to use')
     ap.add_argument('--obsolete', type=str, help='List of obsolete files')
     ap.add_argument('--output', type=str, help='output file name')
+    ap.add_argument('--version', type=str, help='version of InfiniTime, that makes the individual resource files obsolete')
     args = ap.parse_args()
 
     for config_file in args.config:
@@ -31,7 +39,7 @@ def main():
             sys.exit(f'Error: the "obsolete" file {args.obsolete} is not accessible (permissions?).')
 
     zf = ZipFile(args.output, mode='w')
-    resource_files = []
+    packed_resources = []
 
     for config_file in args.config:
         with open(config_file, 'r') as fd:
@@ -40,22 +48,38 @@ def main():
         resource_names = set(data.keys())
         for name in resource_names:
             resource = data[name]
-            resource_files.append({
-                "filename": name+'.bin',
-                "path": resource['target_path'] + name+'.bin'
-            })
-
             path = name + '.bin'
             if not os.path.exists(path):
                 path = os.path.join(os.path.dirname(sys.argv[0]), path)
-            zf.write(path)
+            with open(path, 'rb') as fd:
+                packed_resources.append((resource['target_path'] + name + '.bin', fd.read()))
+
+    # All the resources are installed as a single file, read by ResourcePack in the firmware
+    try:
+        pack = build_pack(packed_resources)
+    except ValueError as e:
+        sys.exit(f'Error: {e}')
+    with open(PACK_FILENAME, 'wb') as fd:
+        fd.write(pack)
+    zf.write(PACK_FILENAME)
+    resource_files = [{
+        "filename": PACK_FILENAME,
+        "path": PACK_PATH
+    }]
 
     if args.obsolete:
         obsolete_file_path = os.path.join(os.path.dirname(sys.argv[0]), args.obsolete)
         with open(obsolete_file_path, 'r') as fd:
             obsolete_data = json.load(fd)
     else:
-        obsolete_data = {}
+        obsolete_data = []
+    # The files installed individually by the previous versions are now in the pack
+    if args.version:
+        for path in sorted(path for path, _ in packed_resources):
+            obsolete_data.append({
+                "path": path,
+                "since": args.version
+            })
     output = {
         'resources': resource_files,
         'obsolete_files': obsolete_data
@@ -4818,7 +4818,7 @@
 // <q> NRFX_TWIM1_ENABLED  - Enable TWIM1 instance
 
 #ifndef NRFX_TWIM1_ENABLED
-  #define NRFX_TWIM1_ENABLED 1
+  #define NRFX_TWIM1_ENABLED 0
 #endif
 
 // <o> NRFX_TWIM_DEFAULT_CONFIG_FREQUENCY  - Frequency
@@ -7,45 +7,52 @@
 // calloc and realloc.
 // See https://www.gnu.org/software/libc/manual/html_node/Replacing-malloc.html
 
+// The caller of these functions is the call site recorded by the heap trace (HEAP_TRACE), see heap_4_infinitime.c
+void* pvPortMallocFrom(size_t xWantedSize, void* pvCallSite);
+void vPortFreeFrom(void* pv, void* pvCallSite);
+void* pvPortReallocFrom(void* pv, size_t xWantedSize, void* pvCallSite);
+
 void* malloc(size_t size) {
-  return pvPortMalloc(size);
+  return pvPortMallocFrom(size, __builtin_return_address(0));
 }
 
 void* __wrap_malloc(size_t size) {
-  return malloc(size);
+  return pvPortMallocFrom(size, __builtin_return_address(0));
 }
 
 void* __wrap__malloc_r(struct _reent* reent, size_t size) {
   (void) reent;
-  return malloc(size);
+  return pvPortMallocFrom(size, __builtin_return_address(0));
 }
 
 void free(void* ptr) {
-  vPortFree(ptr);
+  vPortFreeFrom(ptr, __builtin_return_address(0));
 }
 
 void __wrap_free(void* ptr) {
-  free(ptr);
+  vPortFreeFrom(ptr, __builtin_return_address(0));
 }
 
-void* calloc(size_t num, size_t size) {
-  void *ptr = malloc(num * size);
+static void* CallocFrom(size_t num, size_t size, void* callSite) {
+  void *ptr = pvPortMallocFrom(num * size, callSite);
   if (ptr) {
     memset(ptr, 0, num * size);
   }
   return ptr;
 }
 
-void* __wrap_calloc(size_t num, size_t size) {
-  return calloc(num, size);
+void* calloc(size_t num, size_t size) {
+  return CallocFrom(num, size, __builtin_return_address(0));
 }
 
-void* pvPortRealloc(void* ptr, size_t xWantedSize);
+void* __wrap_calloc(size_t num, size_t size) {
+  return CallocFrom(num, size, __builtin_return_address(0));
+}
 
 void* realloc(void* ptr, size_t newSize) {
-  return pvPortRealloc(ptr, newSize);
+  return pvPortReallocFrom(ptr, newSize, __builtin_return_address(0));
 }
 
 void* __wrap_realloc(void* ptr, size_t newSize) {
-  return realloc(ptr, newSize);
+  return pvPortReallocFrom(ptr, newSize, __builtin_return_address(0));
 }
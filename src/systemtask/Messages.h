@@ -13,6 +13,7 @@ namespace Pinetime {
       BleFirmwareUpdateStarted,
       BleFirmwareUpdateFinished,
       OnTouchEvent,
+      OnMotionEvent,
       HandleButtonEvent,
       HandleButtonTimerEvent,
       OnDisplayTaskSleeping,
@@ -26,9 +27,12 @@ namespace Pinetime {
       OnPairing,
       SetOffAlarm,
       MeasureBatteryTimerExpired,
+      BleDiscoveryTimerExpired,
+      HousekeepingTimerExpired,
       BatteryPercentageUpdated,
       StartFileTransfer,
       StopFileTransfer,
+      ResourcePackChanged,
       BleRadioEnableToggle
     };
   }
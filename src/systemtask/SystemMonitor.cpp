@@ -1,27 +1,138 @@
-#include "systemtask/SystemTask.h"
-#if NRF_LOG_ENABLED
-  // FreeRtosMonitor
-  #include <FreeRTOS.h>
-  #include <task.h>
-  #include <nrf_log.h>
-
-void Pinetime::System::SystemMonitor::Process() {
-  if (xTaskGetTickCount() - lastTick > 10000) {
-    NRF_LOG_INFO("---------------------------------------\nFree heap : %d", xPortGetFreeHeapSize());
-    TaskStatus_t tasksStatus[10];
-    auto nb = uxTaskGetSystemState(tasksStatus, 10, nullptr);
-    for (uint32_t i = 0; i < nb; i++) {
-      NRF_LOG_INFO("Task [%s] - %d", tasksStatus[i].pcTaskName, tasksStatus[i].usStackHighWaterMark);
-      if (tasksStatus[i].usStackHighWaterMark < 20)
-        NRF_LOG_INFO("WARNING!!! Task %s task is nearly full, only %dB available",
-                     tasksStatus[i].pcTaskName,
-                     tasksStatus[i].usStackHighWaterMark * 4);
-    }
+#include "systemtask/SystemMonitor.h"
+#include "drivers/TwiMaster.h"
+#include <algorithm>
+#include <cstring>
+#include <nrf_log.h>
+
+using namespace Pinetime::System;
+
+void SystemMonitor::Process() {
+  if (xTaskGetTickCount() - lastTick > samplingPeriod) {
+    TakeSample();
     lastTick = xTaskGetTickCount();
   }
 }
+
+void SystemMonitor::RegisterQueue(QueueHandle_t queue) {
+  if (nbQueues < queues.size()) {
+    queues[nbQueues++] = queue;
+  }
+}
+
+void SystemMonitor::SetPowerState(PowerStates state) {
+  TickType_t now = xTaskGetTickCount();
+  powerStateTicks[static_cast<size_t>(powerState)] += now - powerStateSince;
+  powerState = state;
+  powerStateSince = now;
+}
+
+size_t SystemMonitor::GetSamples(Sample* destination, size_t maxSamples) const {
+  // Samples are written by the system task, prevent it from running while they are copied
+  vTaskSuspendAll();
+  size_t nb = std::min(maxSamples, nbSamplesRecorded);
+  size_t first = (nextSample + nbSamples - nbSamplesRecorded) % nbSamples;
+  for (size_t i = 0; i < nb; i++) {
+    destination[i] = samples[(first + i) % nbSamples];
+  }
+  xTaskResumeAll();
+  return nb;
+}
+
+void SystemMonitor::TakeSample() {
+  TaskStatus_t tasksStatus[maxTasks];
+  uint32_t totalRunTime = 0;
+  size_t nbTasks = uxTaskGetSystemState(tasksStatus, maxTasks, &totalRunTime);
+  uint32_t elapsed = totalRunTime - previousTimestamp;
+
+  Sample sample {};
+  sample.timestamp = totalRunTime;
+  sample.freeHeap = xPortGetFreeHeapSize();
+  sample.minimumEverFreeHeap = xPortGetMinimumEverFreeHeapSize();
+
+  for (size_t i = 0; i < maxQueues; i++) {
+    sample.queueDepths[i] = (i < nbQueues) ? uxQueueMessagesWaiting(queues[i]) : 0;
+  }
+
+  for (size_t i = 0; i < previousInterruptCounts.size(); i++) {
+    uint32_t count = interruptCounts[i];
+    sample.interruptCounts[i] = count - previousInterruptCounts[i];
+    previousInterruptCounts[i] = count;
+  }
+
+  SetPowerState(powerState);
+  for (size_t i = 0; i < powerStateTicks.size(); i++) {
+    sample.powerStateTicks[i] = powerStateTicks[i];
+    powerStateTicks[i] = 0;
+  }
+  sample.systemTaskWakeups = systemTaskWakeups;
+  systemTaskWakeups = 0;
+
+  sample.nbTasks = nbTasks;
+  for (size_t i = 0; i < nbTasks; i++) {
+    const TaskStatus_t& status = tasksStatus[i];
+    TaskSample& task = sample.tasks[i];
+    std::strncpy(task.name, status.pcTaskName, sizeof(task.name));
+    task.stackHighWaterMark = status.usStackHighWaterMark;
+
+    // Tasks created since the previous sample have run only during this period
+    uint32_t previousRunTime = 0;
+    for (size_t j = 0; j < nbPreviousTasks; j++) {
+      if (previousTaskNumbers[j] == status.xTaskNumber) {
+        previousRunTime = previousTaskRunTimes[j];
+        break;
+      }
+    }
+    uint32_t runTime = status.ulRunTimeCounter - previousRunTime;
+    task.cpuPermille = (elapsed > 0) ? static_cast<uint16_t>((static_cast<uint64_t>(runTime) * 1000) / elapsed) : 0;
+
+    previousTaskNumbers[i] = status.xTaskNumber;
+    previousTaskRunTimes[i] = status.ulRunTimeCounter;
+  }
+  nbPreviousTasks = nbTasks;
+  previousTimestamp = totalRunTime;
+
+  vTaskSuspendAll();
+  samples[nextSample] = sample;
+  nextSample = (nextSample + 1) % nbSamples;
+  nbSamplesRecorded = std::min(nbSamplesRecorded + 1, nbSamples);
+  xTaskResumeAll();
+
+  LogStacks(tasksStatus, nbTasks);
+  LogTwiStatistics();
+}
+
+void SystemMonitor::LogStacks(const TaskStatus_t* tasksStatus, size_t nbTasksStatus) const {
+#if NRF_LOG_ENABLED
+  NRF_LOG_INFO("---------------------------------------\nFree heap : %d", xPortGetFreeHeapSize());
+  NRF_LOG_INFO("System task wakeups : %d", samples[(nextSample + nbSamples - 1) % nbSamples].systemTaskWakeups);
+  for (size_t i = 0; i < nbTasksStatus; i++) {
+    NRF_LOG_INFO("Task [%s] - %d", tasksStatus[i].pcTaskName, tasksStatus[i].usStackHighWaterMark);
+    if (tasksStatus[i].usStackHighWaterMark < 20)
+      NRF_LOG_INFO("WARNING!!! Task %s task is nearly full, only %dB available",
+                   tasksStatus[i].pcTaskName,
+                   tasksStatus[i].usStackHighWaterMark * 4);
+  }
 #else
-// DummyMonitor
-void Pinetime::System::SystemMonitor::Process() {
+  (void) tasksStatus;
+  (void) nbTasksStatus;
+#endif
 }
+
+void SystemMonitor::LogTwiStatistics() const {
+#if NRF_LOG_ENABLED
+  if (twiMaster == nullptr) {
+    return;
+  }
+  std::array<Drivers::TwiMaster::DeviceStatistics, Drivers::TwiMaster::maxDevices> devices;
+  size_t nbDevices = twiMaster->GetStatistics(devices.data(), devices.size());
+  for (size_t i = 0; i < nbDevices; i++) {
+    const auto& device = devices[i];
+    NRF_LOG_INFO("TWI [0x%02x] - %d transactions, %d errors, latency %d avg / %d max ticks",
+                 device.deviceAddress,
+                 device.transactions,
+                 device.errors,
+                 (device.transactions > 0) ? device.totalLatency / device.transactions : 0,
+                 device.maxLatency);
+  }
 #endif
+}
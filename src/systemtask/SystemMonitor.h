@@ -1,16 +1,110 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <FreeRTOS.h> // declares configUSE_TRACE_FACILITY
+#include <queue.h>
 #include <task.h>
 
 namespace Pinetime {
+  namespace Drivers {
+    class TwiMaster;
+  }
+
   namespace System {
     class SystemMonitor {
     public:
+      // Interrupts counted by CountInterrupt(), reported in each sample
+      enum class Interrupts : uint8_t { Gpiote, Spi, Radio, Twi, Count };
+      // Power states of the system task, the time spent in each of them is reported in each sample
+      enum class PowerStates : uint8_t { Running, GoingToSleep, Sleeping, AODSleeping, Count };
+
+      static constexpr size_t maxTasks = 10;
+      static constexpr size_t maxQueues = 2;
+      // The samples are read in a single BLE attribute (DiagnosticService), which is limited to 512 bytes
+      static constexpr size_t nbSamples = 3;
+      static constexpr TickType_t samplingPeriod = pdMS_TO_TICKS(60 * 1000);
+
+      struct __attribute__((packed)) TaskSample {
+        char name[configMAX_TASK_NAME_LEN];
+        // Share of the sampling period spent in this task, in 1/1000
+        uint16_t cpuPermille;
+        // In words
+        uint16_t stackHighWaterMark;
+      };
+
+      struct __attribute__((packed)) Sample {
+        // Run time counter (RTC ticks) at the end of the sampling period
+        uint32_t timestamp;
+        uint32_t freeHeap;
+        uint32_t minimumEverFreeHeap;
+        uint8_t queueDepths[maxQueues];
+        // Number of interrupts during the sampling period
+        uint32_t interruptCounts[static_cast<size_t>(Interrupts::Count)];
+        // Time spent in each power state during the sampling period, in ticks
+        uint32_t powerStateTicks[static_cast<size_t>(PowerStates::Count)];
+        // Number of messages that woke the system task up during the sampling period
+        uint16_t systemTaskWakeups;
+        uint8_t nbTasks;
+        TaskSample tasks[maxTasks];
+      };
+
       void Process();
-#if configUSE_TRACE_FACILITY == 1
+
+      // The depth of the registered queues is recorded in each sample, in the order of registration
+      void RegisterQueue(QueueHandle_t queue);
+
+      // The per-device statistics of the TWI bus are logged with each sample
+      void RegisterTwiMaster(const Drivers::TwiMaster& twiMaster) {
+        this->twiMaster = &twiMaster;
+      }
+
+      // Must be called by the system task on each transition
+      void SetPowerState(PowerStates state);
+
+      // Must be called by the system task each time it's woken up
+      void CountSystemTaskWakeup() {
+        systemTaskWakeups++;
+      }
+
+      // Copies the recorded samples, oldest first, and returns how many were copied
+      size_t GetSamples(Sample* samples, size_t maxSamples) const;
+
+      // Safe to call from interrupt handlers
+      static void CountInterrupt(Interrupts interrupt) {
+        interruptCounts[static_cast<size_t>(interrupt)]++;
+      }
+
     private:
-      mutable TickType_t lastTick = 0;
-#endif
+      void TakeSample();
+      void LogStacks(const TaskStatus_t* tasksStatus, size_t nbTasksStatus) const;
+      void LogTwiStatistics() const;
+
+      static inline std::array<std::atomic<uint32_t>, static_cast<size_t>(Interrupts::Count)> interruptCounts {};
+
+      TickType_t lastTick = 0;
+
+      std::array<QueueHandle_t, maxQueues> queues {};
+      size_t nbQueues = 0;
+
+      const Drivers::TwiMaster* twiMaster = nullptr;
+
+      PowerStates powerState = PowerStates::Running;
+      TickType_t powerStateSince = 0;
+      std::array<uint32_t, static_cast<size_t>(PowerStates::Count)> powerStateTicks {};
+      uint16_t systemTaskWakeups = 0;
+
+      std::array<Sample, nbSamples> samples;
+      size_t nextSample = 0;
+      size_t nbSamplesRecorded = 0;
+
+      // Values at the previous sample, used to compute the deltas
+      std::array<uint32_t, static_cast<size_t>(Interrupts::Count)> previousInterruptCounts {};
+      std::array<UBaseType_t, maxTasks> previousTaskNumbers {};
+      std::array<uint32_t, maxTasks> previousTaskRunTimes {};
+      size_t nbPreviousTasks = 0;
+      uint32_t previousTimestamp = 0;
     };
   }
 }
@@ -32,6 +32,16 @@ void MeasureBatteryTimerCallback(TimerHandle_t xTimer) {
   sysTask->PushMessage(Pinetime::System::Messages::MeasureBatteryTimerExpired);
 }
 
+void BleDiscoveryTimerCallback(TimerHandle_t xTimer) {
+  auto* sysTask = static_cast<SystemTask*>(pvTimerGetTimerID(xTimer));
+  sysTask->PushMessage(Pinetime::System::Messages::BleDiscoveryTimerExpired);
+}
+
+void HousekeepingTimerCallback(TimerHandle_t xTimer) {
+  auto* sysTask = static_cast<SystemTask*>(pvTimerGetTimerID(xTimer));
+  sysTask->PushMessage(Pinetime::System::Messages::HousekeepingTimerExpired);
+}
+
 SystemTask::SystemTask(Drivers::SpiMaster& spi,
                        Pinetime::Drivers::SpiNorFlash& spiNorFlash,
                        Drivers::TwiMaster& twiMaster,
@@ -143,6 +153,10 @@ void SystemTask::Work() {
   displayApp.Register(&nimbleController.navigation());
   displayApp.Start(bootError);
 
+  monitor.RegisterQueue(systemTasksMsgQueue);
+  monitor.RegisterQueue(displayApp.MessageQueue());
+  monitor.RegisterTwiMaster(twiMaster);
+
   heartRateSensor.Init();
   heartRateSensor.Disable();
   heartRateApp.Start();
@@ -169,6 +183,12 @@ void SystemTask::Work() {
   nrfx_gpiote_in_init(PinMap::Cst816sIrq, &pinConfig, nrfx_gpiote_evt_handler);
   nrfx_gpiote_in_event_enable(PinMap::Cst816sIrq, true);
 
+  // Accelerometer FIFO watermark
+  pinConfig.sense = NRF_GPIOTE_POLARITY_LOTOHI;
+  pinConfig.pull = NRF_GPIO_PIN_NOPULL;
+  nrfx_gpiote_in_init(PinMap::Bma421Irq, &pinConfig, nrfx_gpiote_evt_handler);
+  nrfx_gpiote_in_event_enable(PinMap::Bma421Irq, true);
+
   // Power present
   pinConfig.sense = NRF_GPIOTE_POLARITY_TOGGLE;
   pinConfig.pull = NRF_GPIO_PIN_NOPULL;
@@ -180,13 +200,17 @@ void SystemTask::Work() {
   measureBatteryTimer = xTimerCreate("measureBattery", batteryMeasurementPeriod, pdTRUE, this, MeasureBatteryTimerCallback);
   xTimerStart(measureBatteryTimer, portMAX_DELAY);
 
+  bleDiscoveryTimer = xTimerCreate("bleDiscovery", bleDiscoveryDelay, pdFALSE, this, BleDiscoveryTimerCallback);
+  housekeepingTimer = xTimerCreate("housekeeping", housekeepingPeriod, pdTRUE, this, HousekeepingTimerCallback);
+  xTimerStart(housekeepingTimer, portMAX_DELAY);
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "EndlessLoop"
   while (true) {
-    UpdateMotion();
-
     Messages msg;
-    if (xQueueReceive(systemTasksMsgQueue, &msg, 100) == pdTRUE) {
+    // Only messages wake the system task up, periodic work is scheduled by timers
+    if (xQueueReceive(systemTasksMsgQueue, &msg, portMAX_DELAY) == pdTRUE) {
+      monitor.CountSystemTaskWakeup();
       switch (msg) {
         case Messages::EnableSleeping:
           wakeLocksHeld--;
@@ -220,8 +244,12 @@ void SystemTask::Work() {
           break;
         case Messages::BleConnected:
           displayApp.PushMessage(Pinetime::Applications::Display::Messages::NotifyDeviceActivity);
-          isBleDiscoveryTimerRunning = true;
-          bleDiscoveryTimer = 5;
+          xTimerStart(bleDiscoveryTimer, 0);
+          break;
+        case Messages::BleDiscoveryTimerExpired:
+          // Services discovery is deferred to avoid the conflicts between the host communicating with the
+          // target and vice-versa. I'm not sure if this is the right way to handle this...
+          nimbleController.StartDiscovery();
           break;
         case Messages::BleFirmwareUpdateStarted:
           GoToRunning();
@@ -245,6 +273,12 @@ void SystemTask::Work() {
           wakeLocksHeld--;
           // TODO add intent of fs access icon or something
           break;
+        case Messages::ResourcePackChanged:
+          displayApp.PushMessage(Pinetime::Applications::Display::Messages::ReloadResources);
+          break;
+        case Messages::OnMotionEvent:
+          UpdateMotion();
+          break;
         case Messages::OnTouchEvent:
           // Finish immediately if no new events
           if (!touchHandler.ProcessTouchInfo(touchPanel.GetTouchInfo())) {
@@ -310,9 +344,9 @@ void SystemTask::Work() {
           }
 
           if (msg == Messages::OnDisplayTaskSleeping) {
-            state = SystemTaskState::Sleeping;
+            SetState(SystemTaskState::Sleeping);
           } else {
-            state = SystemTaskState::AODSleeping;
+            SetState(SystemTaskState::AODSleeping);
           }
           break;
         case Messages::OnNewDay:
@@ -344,6 +378,21 @@ void SystemTask::Work() {
         case Messages::MeasureBatteryTimerExpired:
           batteryController.MeasureVoltage();
           break;
+        case Messages::HousekeepingTimerExpired:
+          monitor.Process();
+          // Also sends the hour, half hour and day notifications when they're due
+          NoInit_BackUpTime = dateTimeController.CurrentDateTime();
+          if (nrf_gpio_pin_read(PinMap::Button) == 0) {
+            watchdog.Reload();
+          }
+          // Motion can be needed without a state change (BLE motion subscription while sleeping)
+          motionSensor.SetFifoInterrupt(IsMotionNeeded());
+          // The watermark pin stays high until the FIFO is read: if its rising edge was missed
+          // (message queue full), no other interrupt would ever be generated
+          if (nrf_gpio_pin_read(PinMap::Bma421Irq) != 0) {
+            UpdateMotion();
+          }
+          break;
         case Messages::BatteryPercentageUpdated:
           nimbleController.NotifyBatteryLevel(batteryController.PercentRemaining());
           break;
@@ -362,23 +411,6 @@ void SystemTask::Work() {
           break;
       }
     }
-
-    if (isBleDiscoveryTimerRunning) {
-      if (bleDiscoveryTimer == 0) {
-        isBleDiscoveryTimerRunning = false;
-        // Services discovery is deferred from 3 seconds to avoid the conflicts between the host communicating with the
-        // target and vice-versa. I'm not sure if this is the right way to handle this...
-        nimbleController.StartDiscovery();
-      } else {
-        bleDiscoveryTimer--;
-      }
-    }
-
-    monitor.Process();
-    NoInit_BackUpTime = dateTimeController.CurrentDateTime();
-    if (nrf_gpio_pin_read(PinMap::Button) == 0) {
-      watchdog.Reload();
-    }
   }
 #pragma clang diagnostic pop
 }
@@ -408,7 +440,7 @@ void SystemTask::GoToRunning() {
     nimbleController.RestartFastAdv();
   }
 
-  state = SystemTaskState::Running;
+  SetState(SystemTaskState::Running);
 };
 
 void SystemTask::GoToSleep() {
@@ -426,15 +458,40 @@ void SystemTask::GoToSleep() {
   }
   heartRateApp.PushMessage(Pinetime::Applications::HeartRateTask::Messages::GoToSleep);
 
-  state = SystemTaskState::GoingToSleep;
+  SetState(SystemTaskState::GoingToSleep);
 };
 
-void SystemTask::UpdateMotion() {
+void SystemTask::SetState(SystemTaskState newState) {
+  state = newState;
+  // Don't wake up on accelerometer interrupts if the samples are not used
+  motionSensor.SetFifoInterrupt(IsMotionNeeded());
+  switch (newState) {
+    case SystemTaskState::Running:
+      monitor.SetPowerState(SystemMonitor::PowerStates::Running);
+      break;
+    case SystemTaskState::GoingToSleep:
+      monitor.SetPowerState(SystemMonitor::PowerStates::GoingToSleep);
+      break;
+    case SystemTaskState::Sleeping:
+      monitor.SetPowerState(SystemMonitor::PowerStates::Sleeping);
+      break;
+    case SystemTaskState::AODSleeping:
+      monitor.SetPowerState(SystemMonitor::PowerStates::AODSleeping);
+      break;
+  }
+}
+
+bool SystemTask::IsMotionNeeded() const {
   // Only consider disabling motion updates specifically in the Sleeping state
   // AOD needs motion on to show up to date step counts
-  if (state == SystemTaskState::Sleeping && !(settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) ||
-                                              settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake) ||
-                                              motionController.GetService()->IsMotionNotificationSubscribed())) {
+  return state != SystemTaskState::Sleeping || settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) ||
+         settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake) ||
+         motionController.GetService()->IsMotionNotificationSubscribed();
+}
+
+// Called when the accelerometer FIFO reaches its watermark
+void SystemTask::UpdateMotion() {
+  if (!IsMotionNeeded()) {
     return;
   }
 
@@ -443,21 +500,30 @@ void SystemTask::UpdateMotion() {
     stepCounterMustBeReset = false;
   }
 
-  auto motionValues = motionSensor.Process();
+  std::array<Drivers::Bma421::Acceleration, Drivers::Bma421::maxFifoSamples> samples;
+  size_t nbSamples = motionSensor.ReadFifo(samples.data(), samples.size());
+  uint32_t steps = motionSensor.ReadStepCount();
 
-  motionController.Update(motionValues.x, motionValues.y, motionValues.z, motionValues.steps);
+  // The last sample was acquired just before the interrupt, the previous ones at the sampling period of the FIFO
+  TickType_t now = xTaskGetTickCount();
+  constexpr TickType_t samplePeriod = pdMS_TO_TICKS(Drivers::Bma421::fifoSamplePeriodMs);
 
-  if (settingsController.GetNotificationStatus() != Controllers::Settings::Notification::Sleep) {
-    if ((settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) &&
-         motionController.ShouldRaiseWake()) ||
-        (settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake) &&
-         motionController.ShouldShakeWake(settingsController.GetShakeThreshold()))) {
-      GoToRunning();
+  for (size_t i = 0; i < nbSamples; i++) {
+    TickType_t timestamp = now - (nbSamples - 1 - i) * samplePeriod;
+    motionController.Update(samples[i].x, samples[i].y, samples[i].z, steps, timestamp);
+
+    if (settingsController.GetNotificationStatus() != Controllers::Settings::Notification::Sleep) {
+      if ((settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) &&
+           motionController.ShouldRaiseWake()) ||
+          (settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::Shake) &&
+           motionController.ShouldShakeWake(settingsController.GetShakeThreshold()))) {
+        GoToRunning();
+      }
+    }
+    if (settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::LowerWrist) && state == SystemTaskState::Running &&
+        motionController.ShouldLowerSleep()) {
+      GoToSleep();
     }
-  }
-  if (settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::LowerWrist) && state == SystemTaskState::Running &&
-      motionController.ShouldLowerSleep()) {
-    GoToSleep();
   }
 }
 
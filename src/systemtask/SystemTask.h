@@ -89,6 +89,10 @@ namespace Pinetime {
         return state != SystemTaskState::Running;
       }
 
+      const SystemMonitor& Monitor() const {
+        return monitor;
+      }
+
     private:
       TaskHandle_t taskHandle;
 
@@ -119,9 +123,9 @@ namespace Pinetime {
 
       static void Process(void* instance);
       void Work();
-      bool isBleDiscoveryTimerRunning = false;
-      uint8_t bleDiscoveryTimer = 0;
       TimerHandle_t measureBatteryTimer;
+      TimerHandle_t bleDiscoveryTimer;
+      TimerHandle_t housekeepingTimer;
       uint8_t wakeLocksHeld = 0;
       SystemTaskState state = SystemTaskState::Running;
 
@@ -130,9 +134,14 @@ namespace Pinetime {
 
       void GoToRunning();
       void GoToSleep();
+      void SetState(SystemTaskState newState);
       void UpdateMotion();
+      bool IsMotionNeeded() const;
       bool stepCounterMustBeReset = false;
       static constexpr TickType_t batteryMeasurementPeriod = pdMS_TO_TICKS(10 * 60 * 1000);
+      static constexpr TickType_t bleDiscoveryDelay = pdMS_TO_TICKS(500);
+      // Reloads the watchdog (7 s timeout), backs up the time and drives the SystemMonitor sampling
+      static constexpr TickType_t housekeepingPeriod = pdMS_TO_TICKS(3000);
 
       SystemMonitor monitor;
     };
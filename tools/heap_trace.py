@@ -0,0 +1,368 @@
+#!/usr/bin/env python3
+
+"""Decode the allocation trace recorded by heap_4_infinitime.c (build with -DHEAP_TRACE=1).
+
+The input is a RAM dump taken with a debugger, either of the whole RAM (nrfjprog --readram ram.bin) or of the
+xHeapTrace variable only. The trace is located by its header.
+
+  heap_trace.py report ram.bin [--elf pinetime-app.out]
+      Fragmentation over time, allocations still alive at the end of the trace (leak candidates) and lifetime of
+      the allocations, per call site.
+
+  heap_trace.py replay ram.bin
+      Replays the allocations and frees of the trace against several allocator strategies, on a simulated heap of
+      the same size, and compares their fragmentation and failures.
+"""
+
+import argparse
+import bisect
+import collections
+import shutil
+import struct
+import subprocess
+import sys
+
+HEADER = struct.Struct("<IHHIIII")
+RECORD = struct.Struct("<IIHHHH")
+MAGIC = 0x43525448
+VERSION = 1
+NO_BLOCK = 0xFFFF
+TICK_RATE_HZ = 1024
+
+# Like heap_4: every block starts with an 8 bytes header and is aligned on 8 bytes
+BLOCK_HEADER_SIZE = 8
+ALIGNMENT = 8
+
+
+class Record:
+    def __init__(self, timestamp, call_site, offset, size, free_size, largest_free_block):
+        self.timestamp = timestamp
+        self.call_site = call_site & ~1
+        self.is_free = (call_site & 1) == 1
+        self.offset = offset
+        self.size = size
+        self.free_size = free_size
+        self.largest_free_block = largest_free_block
+
+    @property
+    def failed(self):
+        return not self.is_free and self.offset == NO_BLOCK
+
+    @property
+    def fragmentation(self):
+        if self.free_size == 0:
+            return 0.0
+        return 1.0 - self.largest_free_block / self.free_size
+
+
+class Trace:
+    def __init__(self, heap_start, heap_size, recorded, records):
+        self.heap_start = heap_start
+        self.heap_size = heap_size
+        self.recorded = recorded
+        self.records = records
+
+    @property
+    def lost(self):
+        return self.recorded - len(self.records)
+
+
+def load_trace(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    magic = struct.pack("<I", MAGIC)
+    position = data.find(magic)
+    while position >= 0:
+        if position + HEADER.size <= len(data):
+            _, version, record_size, capacity, recorded, heap_start, heap_size = HEADER.unpack_from(data, position)
+            end = position + HEADER.size + capacity * record_size
+            if version == VERSION and record_size == RECORD.size and end <= len(data):
+                return decode_records(data, position + HEADER.size, capacity, recorded, heap_start, heap_size)
+        position = data.find(magic, position + 1)
+
+    sys.exit("{}: no heap trace found (is the firmware built with -DHEAP_TRACE=1?)".format(path))
+
+
+def decode_records(data, start, capacity, recorded, heap_start, heap_size):
+    nb_records = min(recorded, capacity)
+    first = recorded % capacity if recorded > capacity else 0
+    records = []
+    for i in range(nb_records):
+        index = (first + i) % capacity
+        records.append(Record(*RECORD.unpack_from(data, start + index * RECORD.size)))
+    return Trace(heap_start, heap_size, recorded, records)
+
+
+class Symbolizer:
+    def __init__(self, elf):
+        self.elf = elf
+        self.cache = {}
+        self.addr2line = shutil.which("arm-none-eabi-addr2line") if elf else None
+        if elf and self.addr2line is None:
+            print("arm-none-eabi-addr2line not found, call sites are not symbolized", file=sys.stderr)
+
+    def name(self, address):
+        if self.addr2line is None:
+            return "0x{:08x}".format(address)
+        if address not in self.cache:
+            # The return address points after the call instruction
+            output = subprocess.run([self.addr2line, "-f", "-C", "-s", "-e", self.elf, hex(address - 2)],
+                                    capture_output=True, text=True).stdout.split("\n")
+            function = output[0] if output else "??"
+            location = output[1] if len(output) > 1 else "??"
+            self.cache[address] = "0x{:08x} {} ({})".format(address, function, location)
+        return self.cache[address]
+
+
+def seconds(ticks):
+    return ticks / TICK_RATE_HZ
+
+
+def report(trace, symbolizer, nb_timeline_points):
+    records = trace.records
+    if not records:
+        print("The trace is empty")
+        return
+
+    print("Heap : {} bytes at 0x{:08x}".format(trace.heap_size, trace.heap_start))
+    print("Records : {} ({} older ones overwritten), from {:.1f}s to {:.1f}s".format(
+        len(records), trace.lost, seconds(records[0].timestamp), seconds(records[-1].timestamp)))
+
+    print("\nFragmentation (1 - largest free block / free size)")
+    worst = max(records, key=lambda r: r.fragmentation)
+    least_largest = min(records, key=lambda r: r.largest_free_block)
+    print("  at the end : {:.0%}, {} free, largest block {}".format(
+        records[-1].fragmentation, records[-1].free_size, records[-1].largest_free_block))
+    print("  worst : {:.0%} at {:.1f}s, {} free, largest block {}".format(
+        worst.fragmentation, seconds(worst.timestamp), worst.free_size, worst.largest_free_block))
+    print("  smallest largest block : {} at {:.1f}s".format(
+        least_largest.largest_free_block, seconds(least_largest.timestamp)))
+    step = max(1, len(records) // nb_timeline_points)
+    for record in records[::step]:
+        bar = "#" * int(record.fragmentation * 40)
+        print("  {:8.1f}s free {:6} largest {:6} {:4.0%} {}".format(
+            seconds(record.timestamp), record.free_size, record.largest_free_block, record.fragmentation, bar))
+
+    failures = [r for r in records if r.failed]
+    if failures:
+        print("\nFailed allocations")
+        for record in failures:
+            print("  {:8.1f}s {:6} bytes, largest block {:6} : {}".format(
+                seconds(record.timestamp), record.size, record.largest_free_block, symbolizer.name(record.call_site)))
+
+    # Match the frees with the allocations at the same offset
+    alive = {}
+    lifetimes = collections.defaultdict(list)
+    unmatched_frees = 0
+    for record in records:
+        if record.failed:
+            continue
+        if record.is_free:
+            allocation = alive.pop(record.offset, None)
+            if allocation is None:
+                unmatched_frees += 1
+            else:
+                lifetimes[allocation.call_site].append(record.timestamp - allocation.timestamp)
+        else:
+            alive[record.offset] = record
+
+    end = records[-1].timestamp
+    print("\nAllocations alive at the end of the trace, per call site (leak candidates)")
+    leaks = collections.defaultdict(list)
+    for allocation in alive.values():
+        leaks[allocation.call_site].append(allocation)
+    for call_site, allocations in sorted(leaks.items(), key=lambda item: -sum(a.size for a in item[1])):
+        print("  {:4} allocations, {:6} bytes, oldest {:8.1f}s ago : {}".format(
+            len(allocations), sum(a.size for a in allocations), seconds(end - min(a.timestamp for a in allocations)),
+            symbolizer.name(call_site)))
+    if unmatched_frees > 0:
+        print("  ({} frees of memory allocated before the start of the trace)".format(unmatched_frees))
+
+    print("\nLifetime of the freed allocations, per call site")
+    for call_site, values in sorted(lifetimes.items(), key=lambda item: -len(item[1])):
+        values.sort()
+        print("  {:4} allocations, median {:8.2f}s, max {:8.2f}s : {}".format(
+            len(values), seconds(values[len(values) // 2]), seconds(values[-1]), symbolizer.name(call_site)))
+
+
+class FreeListAllocator:
+    """Free list sorted by address with coalescing, like heap_4. The strategy picks the free block to split."""
+
+    def __init__(self, heap_size, strategy):
+        self.strategy = strategy
+        self.starts = [0]
+        self.sizes = {0: heap_size - BLOCK_HEADER_SIZE}
+        self.allocated = {}
+        self.next_index = 0
+        self.steps = 0
+
+    def free_size(self):
+        return sum(self.sizes.values())
+
+    def largest_free_block(self):
+        return max(self.sizes.values(), default=0)
+
+    def allocate(self, size):
+        wanted = BLOCK_HEADER_SIZE + (size + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+        index = self.select(wanted)
+        if index is None:
+            return None
+        start = self.starts[index]
+        block_size = self.sizes.pop(start)
+        del self.starts[index]
+        # heap_4 only splits blocks when the remainder is larger than 2 headers
+        if block_size - wanted > 2 * BLOCK_HEADER_SIZE:
+            self.insert(start + wanted, block_size - wanted)
+            block_size = wanted
+        self.allocated[start] = block_size
+        self.next_index = index
+        return start
+
+    def select(self, wanted):
+        candidates = range(len(self.starts))
+        if self.strategy == "next-fit":
+            candidates = list(range(self.next_index, len(self.starts))) + list(range(0, self.next_index))
+        best = None
+        for index in candidates:
+            self.steps += 1
+            size = self.sizes[self.starts[index]]
+            if size < wanted:
+                continue
+            if self.strategy != "best-fit":
+                return index
+            if best is None or size < self.sizes[self.starts[best]]:
+                best = index
+        return best
+
+    def free(self, start):
+        self.insert(start, self.allocated.pop(start))
+
+    def insert(self, start, size):
+        index = bisect.bisect(self.starts, start)
+        if index < len(self.starts) and start + size == self.starts[index]:
+            size += self.sizes.pop(self.starts[index])
+            del self.starts[index]
+        if index > 0 and self.starts[index - 1] + self.sizes[self.starts[index - 1]] == start:
+            self.sizes[self.starts[index - 1]] += size
+        else:
+            self.starts.insert(index, start)
+            self.sizes[start] = size
+
+
+class PoolAllocator:
+    """Size-class pools of fixed-size blocks in front of a first-fit heap, like the LVGL pools."""
+
+    def __init__(self, heap_size, classes=((16, 16), (32, 16), (64, 12), (96, 8))):
+        self.heap = FreeListAllocator(heap_size, "first-fit")
+        self.classes = classes
+        self.slabs = {block_size: [] for block_size, _ in classes}
+        self.owners = {}
+        self.next_handle = 0
+
+    @property
+    def steps(self):
+        return self.heap.steps
+
+    def free_size(self):
+        return self.heap.free_size()
+
+    def largest_free_block(self):
+        return self.heap.largest_free_block()
+
+    def allocate(self, size):
+        for block_size, blocks_per_slab in self.classes:
+            if size > block_size:
+                continue
+            slabs = self.slabs[block_size]
+            slab = next((s for s in slabs if s["used"] < blocks_per_slab), None)
+            if slab is None:
+                start = self.heap.allocate(block_size * blocks_per_slab + ALIGNMENT)
+                if start is None:
+                    break
+                slab = {"start": start, "used": 0}
+                slabs.append(slab)
+            slab["used"] += 1
+            self.next_handle += 1
+            self.owners[self.next_handle] = (block_size, slab)
+            return self.next_handle
+        start = self.heap.allocate(size)
+        if start is None:
+            return None
+        self.next_handle += 1
+        self.owners[self.next_handle] = (None, start)
+        return self.next_handle
+
+    def free(self, handle):
+        block_size, owner = self.owners.pop(handle)
+        if block_size is None:
+            self.heap.free(owner)
+            return
+        owner["used"] -= 1
+        slabs = self.slabs[block_size]
+        if owner["used"] == 0 and len(slabs) > 1:
+            slabs.remove(owner)
+            self.heap.free(owner["start"])
+
+
+def replay(trace):
+    allocations = sum(1 for r in trace.records if not r.is_free)
+    print("Replaying {} allocations on a {} bytes heap, starting empty".format(allocations, trace.heap_size))
+    print("Only the frees of memory allocated within the trace are replayed\n")
+
+    strategies = {
+        "first-fit (heap_4)": FreeListAllocator(trace.heap_size, "first-fit"),
+        "next-fit": FreeListAllocator(trace.heap_size, "next-fit"),
+        "best-fit": FreeListAllocator(trace.heap_size, "best-fit"),
+        "pools + first-fit": PoolAllocator(trace.heap_size),
+    }
+
+    print("{:20} {:>8} {:>14} {:>16} {:>18}".format("Strategy", "Failures", "Worst frag.", "Min largest blk", "Steps/allocation"))
+    for name, allocator in strategies.items():
+        handles = {}
+        failures = 0
+        worst_fragmentation = 0.0
+        min_largest = trace.heap_size
+        for record in trace.records:
+            if record.is_free:
+                handle = handles.pop(record.offset, None)
+                if handle is not None:
+                    allocator.free(handle)
+                continue
+            handle = allocator.allocate(record.size)
+            if handle is None:
+                failures += 1
+                continue
+            if record.offset != NO_BLOCK:
+                handles[record.offset] = handle
+            free_size = allocator.free_size()
+            largest = allocator.largest_free_block()
+            if free_size > 0:
+                worst_fragmentation = max(worst_fragmentation, 1.0 - largest / free_size)
+            min_largest = min(min_largest, largest)
+        print("{:20} {:>8} {:>14.0%} {:>16} {:>18.1f}".format(
+            name, failures, worst_fragmentation, min_largest, allocator.steps / max(1, allocations)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    report_parser = subparsers.add_parser("report", help="fragmentation, leak and lifetime reports")
+    report_parser.add_argument("dump", help="RAM dump containing the trace")
+    report_parser.add_argument("--elf", help="firmware (.out) used to name the call sites")
+    report_parser.add_argument("--timeline", type=int, default=20, help="number of points of the fragmentation timeline")
+
+    replay_parser = subparsers.add_parser("replay", help="compare allocator strategies on the trace")
+    replay_parser.add_argument("dump", help="RAM dump containing the trace")
+
+    args = parser.parse_args()
+    trace = load_trace(args.dump)
+    if args.command == "report":
+        report(trace, Symbolizer(args.elf), args.timeline)
+    else:
+        replay(trace)
+
+
+if __name__ == "__main__":
+    main()
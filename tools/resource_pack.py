@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+
+"""Build and validate the resource packs read by src/components/fs/ResourcePack.cpp.
+
+A resource pack gathers the external resources (fonts, images) in a single file, /resources.pak on the watch.
+
+  resource_pack.py build resources.pak teko.bin=/fonts/teko.bin pine_small.bin=/images/pine_small.bin ...
+      Packs the files, each of them under the path used to open it from the firmware ("F:/fonts/teko.bin").
+
+  resource_pack.py validate resources.pak [--extract DIR]
+      Checks the header, the index and the CRC of each resource, and lists the resources.
+      The resources are extracted to DIR (with their path in the filesystem) if --extract is given.
+
+Format (little endian):
+  Header (16 bytes): magic "IRPK", version (uint16), number of entries (uint16), CRC32 of the index, size of the pack
+  Entry (16 bytes): FNV-1a hash of the path, offset of the data in the pack, size, CRC32 of the data
+The entries are sorted by hash, the data of each resource is aligned on 4 bytes.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+HEADER = struct.Struct("<4sHHII")
+ENTRY = struct.Struct("<IIII")
+MAGIC = b"IRPK"
+VERSION = 1
+# ResourcePack::maxEntries
+MAX_ENTRIES = 32
+ALIGNMENT = 4
+
+
+def fnv1a(path):
+    h = 2166136261
+    for byte in path.encode():
+        h ^= byte
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def build_pack(resources):
+    """resources: list of (path in the filesystem, data). Returns the content of the pack."""
+    if len(resources) > MAX_ENTRIES:
+        raise ValueError(f"{len(resources)} resources, the firmware reads up to {MAX_ENTRIES}")
+
+    hashes = {}
+    for path, _ in resources:
+        h = fnv1a(path)
+        if h in hashes:
+            raise ValueError(f"{path} and {hashes[h]} have the same hash, rename one of them")
+        hashes[h] = path
+
+    resources = sorted(resources, key=lambda resource: fnv1a(resource[0]))
+    offset = HEADER.size + ENTRY.size * len(resources)
+    index = b""
+    data = b""
+    for path, content in resources:
+        padding = -(offset + len(data)) % ALIGNMENT
+        data += b"\0" * padding
+        index += ENTRY.pack(fnv1a(path), offset + len(data), len(content), zlib.crc32(content))
+        data += content
+
+    size = offset + len(data)
+    return HEADER.pack(MAGIC, VERSION, len(resources), zlib.crc32(index), size) + index + data
+
+
+def parse_pack(pack):
+    """Returns the entries of the pack as (hash, offset, size, crc, valid) and the list of errors."""
+    errors = []
+    if len(pack) < HEADER.size:
+        return [], ["shorter than the header"]
+    magic, version, nb_entries, index_crc, size = HEADER.unpack_from(pack)
+    if magic != MAGIC:
+        return [], [f"bad magic {magic!r}"]
+    if version != VERSION:
+        return [], [f"version {version}, expected {VERSION}"]
+    if nb_entries > MAX_ENTRIES:
+        errors.append(f"{nb_entries} entries, the firmware reads up to {MAX_ENTRIES}")
+    if size != len(pack):
+        errors.append(f"size {size} in the header, the file is {len(pack)} bytes long")
+
+    index_end = HEADER.size + ENTRY.size * nb_entries
+    if index_end > len(pack):
+        return [], errors + ["index truncated"]
+    if zlib.crc32(pack[HEADER.size:index_end]) != index_crc:
+        errors.append("bad index CRC, the firmware will ignore the whole pack")
+
+    entries = []
+    previous_hash = None
+    for i in range(nb_entries):
+        h, offset, length, crc = ENTRY.unpack_from(pack, HEADER.size + i * ENTRY.size)
+        if previous_hash is not None and h <= previous_hash:
+            errors.append(f"entry {i} ({h:08x}) is not sorted by hash")
+        previous_hash = h
+        valid = offset >= index_end and offset + length <= len(pack) and zlib.crc32(pack[offset:offset + length]) == crc
+        if not valid:
+            errors.append(f"entry {i} ({h:08x}) is out of the pack or doesn't match its CRC")
+        entries.append((h, offset, length, crc, valid))
+    return entries, errors
+
+
+def parse_resource_argument(argument):
+    file_name, separator, path = argument.partition("=")
+    if not separator or not path.startswith("/"):
+        raise argparse.ArgumentTypeError(f"expected FILE=/PATH, got {argument}")
+    return file_name, path
+
+
+def build(args):
+    resources = []
+    for file_name, path in args.resources:
+        with open(file_name, "rb") as f:
+            resources.append((path, f.read()))
+    try:
+        pack = build_pack(resources)
+    except ValueError as e:
+        sys.exit(f"Error: {e}")
+    with open(args.output, "wb") as f:
+        f.write(pack)
+    print(f"{args.output}: {len(resources)} resources, {len(pack)} bytes")
+
+
+def validate(args):
+    with open(args.pack, "rb") as f:
+        pack = f.read()
+    entries, errors = parse_pack(pack)
+
+    names = {fnv1a(path): path for path in args.names}
+    print(f"{'hash':>8}  {'offset':>8}  {'size':>8}  {'crc':>8}")
+    for h, offset, length, crc, valid in entries:
+        name = names.get(h, "")
+        print(f"{h:08x}  {offset:8}  {length:8}  {crc:08x}  {'ok' if valid else 'CORRUPTED'}  {name}")
+        if args.extract and valid:
+            target = os.path.join(args.extract, name.lstrip("/") if name else f"{h:08x}.bin")
+            os.makedirs(os.path.dirname(target) or ".", exist_ok=True)
+            with open(target, "wb") as f:
+                f.write(pack[offset:offset + length])
+
+    for error in errors:
+        print(f"Error: {error}", file=sys.stderr)
+    sys.exit(1 if errors else 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    subparsers = parser.add_subparsers(dest="command", required=True)
+
+    build_parser = subparsers.add_parser("build", help="pack resource files")
+    build_parser.add_argument("output")
+    build_parser.add_argument("resources", nargs="+", type=parse_resource_argument, metavar="FILE=/PATH")
+    build_parser.set_defaults(func=build)
+
+    validate_parser = subparsers.add_parser("validate", help="check a pack and list its resources")
+    validate_parser.add_argument("pack")
+    validate_parser.add_argument("--names", nargs="*", default=[], metavar="PATH",
+                                 help="paths to show next to the hashes (the pack only contains the hashes)")
+    validate_parser.add_argument("--extract", metavar="DIR", help="extract the resources to this directory")
+    validate_parser.set_defaults(func=validate)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()